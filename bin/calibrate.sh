@@ -10,13 +10,7 @@ echo "Cost Size ID Crossover Mutation Threshold Accept Improvement PopSize" > ${
 
 ########################################################################
 # Generates calibration set
-for i in 50 60 70 80
-do
-    for j in {1..5}
-    do
-        ./instance_generator -N $i > ${INSTANCES_DIR}/${i}_${j}.instance
-    done
-done
+./instance_generator -N 50:80:10 -n 5 -d ${INSTANCES_DIR}
 
 ########################################################################
 # Loops over instances
@@ -3,10 +3,5 @@
 # Generates instances
 OUTDIR=../run/instances
 
-for size in {10..80..10}
-do
-    for repeat in {1..20}
-    do
-        ./instance_generator -N ${size} > ${OUTDIR}/${size}_${repeat}.instance
-    done
-done
+# Sizes from 10 to 80, step 10, 20 instances per size, in one process
+./instance_generator -N 10:80:10 -n 20 -d ${OUTDIR}
@@ -16,12 +16,33 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
+#include <climits>
 #include <cstddef>
+#include <limits>
+#include <algorithm>
+#include <utility>
 #include <vector>
 #include <map>
+#include <fstream>
 
 #include "Instance.h"
+#include "NodeSet.h"
+#include "Parallel.h"
+#include "Parser.h"
+#include "Writer.h"
+#include "matrix/Dense.h"
+#include "matrix/Sparse.h"
+#include "matrix/Lazy.h"
+#include "matrix/Triangular.h"
+
+using costFunction::Coordinates;
 
 /**
  * Prints an error when malloc cannot allocate memory.
@@ -40,6 +61,394 @@
     }
 
 
+/**
+ * Prints an error about an instance file and terminates.
+ */
+#define IO_ERROR(path, msg) {                                  \
+    fprintf(stderr, "[%s: %d]: %s: %s\n",                       \
+            __FILE__, __LINE__, (path), (msg));                  \
+    exit(EXIT_FAILURE);                                          \
+}
+
+
+/** Magic string identifying binary instances. */
+static const char BINARY_MAGIC[8] = {'M', 'E', 'M', 'O', 'C', 'I', 'N', 'S'};
+
+/** Version of the binary format. */
+static const uint32_t BINARY_VERSION = 2;
+
+/** Flag of binary instances whose costs are known to be symmetric. */
+static const uint32_t BINARY_SYMMETRIC = 1;
+
+/** Flag of binary instances storing the upper triangle of costs only. */
+static const uint32_t BINARY_TRIANGULAR = 2;
+
+/** Flag of binary instances storing a cost function instead of costs. */
+static const uint32_t BINARY_LAZY = 4;
+
+/** Every flag of binary instances. */
+static const uint32_t BINARY_FLAGS =
+    BINARY_SYMMETRIC | BINARY_TRIANGULAR | BINARY_LAZY;
+
+/** Byte order mark of the binary format. */
+static const uint32_t BINARY_ENDIANNESS = 0x01020304;
+
+/** Alignment of the cost matrix in binary instances. */
+static const uint64_t BINARY_ALIGNMENT = 4096;
+
+/** Marks identifiers which do not belong to any node. */
+static const unsigned int NO_INDEX = UINT_MAX;
+
+/** Rows of the nodes map written at once by save functions. */
+static const size_t ROWS_PER_BLOCK = 64;
+
+/** Rows computed by a single task when building a cost matrix. */
+static const size_t ROWS_PER_TASK = 16;
+
+/** Columns scanned by a single task when looking for predecessors. */
+static const size_t COLUMNS_PER_TASK = 64;
+
+/** Side of the square tiles compared by a single symmetry check. */
+static const size_t SYMMETRY_TILE = 64;
+
+/** Tasks computed at a time when building a sparse matrix, per thread. */
+static const size_t TASKS_PER_THREAD = 4;
+
+
+/** Header of a binary instance. */
+struct binary_header_s {
+    char magic[8];          ///< Magic string
+    uint32_t version;       ///< Version of the format
+    uint32_t endianness;    ///< Byte order mark
+    uint64_t size;          ///< Number of nodes
+    uint64_t map_size;      ///< Size of the nodes map
+    uint32_t min_id;        ///< Minimum identifier
+    uint32_t max_id;        ///< Maximum identifier
+    uint64_t nodes_offset;  ///< Offset of the table of nodes
+    uint64_t costs_offset;  ///< Offset of the cost matrix
+    uint32_t flags;         ///< Flags about costs, since version 2
+    uint32_t reserved;      ///< Padding, always zero
+};
+
+/** A node in a binary instance. */
+struct binary_node_s {
+    uint32_t id;        ///< Identifier of the node
+    uint32_t reserved;  ///< Padding, always zero
+    double x;           ///< X-coordinate
+    double y;           ///< Y-coordinate
+};
+
+/** An unfair cost function, stored by lazy binary instances. */
+struct binary_function_s {
+    double p;       ///< P-parameter of the Minkowski distance
+    double mi;      ///< Mean of the random component
+    double sigma;   ///< Variance of the random component
+    double t;       ///< Threshold above which an arc is removed
+    uint64_t seed;  ///< Seed of the random components
+};
+
+/** Type of the header of a binary instance. */
+typedef struct binary_header_s BinaryHeader;
+
+/** Type of a node in a binary instance. */
+typedef struct binary_node_s BinaryNode;
+
+/** Type of a cost function stored by a binary instance. */
+typedef struct binary_function_s BinaryFunction;
+
+
+/**
+ * Tells whether general data of an instance are consistent.
+ * Identifiers must fit in a map of given size, and the cost matrix must
+ * fit in memory.
+ * @param[in] size     Number of nodes
+ * @param[in] map_size Size of the nodes map
+ * @param[in] min_id   Minimum identifier
+ * @param[in] max_id   Maximum identifier
+ * @return True iff general data are consistent
+ */
+static bool layout_valid(
+    const uint64_t size,
+    const uint64_t map_size,
+    const uint64_t min_id,
+    const uint64_t max_id) {
+    const uint64_t limit = std::numeric_limits<size_t>::max();
+
+    if (map_size > 0 && map_size > limit / sizeof(double) / map_size) {
+        return false;
+    }
+
+    return size <= map_size
+        && (size == 0 || (min_id <= max_id
+                          && max_id <= UINT_MAX
+                          && max_id - min_id < map_size));
+}
+
+
+/**
+ * Tells whether identifiers of nodes lie between given bounds.
+ * @param[in] nodes  Nodes to check
+ * @param[in] min_id Minimum identifier
+ * @param[in] max_id Maximum identifier
+ * @return True iff every identifier lies in [min_id, max_id]
+ */
+static bool nodes_valid(
+    const vector<Node> &nodes,
+    const uint64_t min_id,
+    const uint64_t max_id) {
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const uint64_t id = nodes[i].getId();
+        if (id < min_id || id > max_id) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * Creates the unfair cost function stored by a lazy binary instance.
+ * Terminates if parameters do not describe a valid function.
+ * @param[in] function Parameters of the cost function
+ * @param[in] path     Path of the instance, for error messages
+ * @return A new cost function, owned by the caller
+ */
+static const costFunction::Unfair *unfair_create(
+    const BinaryFunction &function,
+    const char *path) {
+    if (!(function.p > 0.0)) {
+        IO_ERROR(path, "Invalid binary instance.");
+    }
+
+    return new costFunction::Unfair(
+        function.p, function.mi, function.sigma, function.t, function.seed);
+}
+
+
+/**
+ * Returns size of the header of a binary instance.
+ * Headers of version 1 end before flags.
+ * @param[in] header Header of the instance
+ * @return Size of the header, in bytes
+ */
+static size_t binary_header_size(const BinaryHeader &header) {
+    return (header.version < 2) ? offsetof(BinaryHeader, flags)
+                                : sizeof(BinaryHeader);
+}
+
+
+/**
+ * Completes a header read from a binary instance.
+ * Headers of version 1 have no flags: whatever follows them is cleared.
+ * @param[in, out] header Header to complete
+ */
+static void binary_header_complete(BinaryHeader *header) {
+    if (header->version < 2) {
+        header->flags    = 0;
+        header->reserved = 0;
+    }
+}
+
+
+/**
+ * Returns size of the cost matrix of a binary instance.
+ * Header must describe a cost matrix which fits in memory. Lazy
+ * instances store a cost function instead.
+ * @param[in] header Header of the instance
+ * @return Size of the cost matrix, in bytes
+ */
+static uint64_t binary_costs_size(const BinaryHeader &header) {
+    if (header.flags & BINARY_LAZY) {
+        return sizeof(BinaryFunction);
+    }
+
+    const uint64_t elements = (header.flags & BINARY_TRIANGULAR)
+                            ? header.map_size * (header.map_size + 1) / 2
+                            : header.map_size * header.map_size;
+
+    return elements * sizeof(double);
+}
+
+
+/**
+ * Tells whether a header belongs to a supported binary instance.
+ * Offsets must leave room for the table of nodes and be aligned to
+ * doubles, since nodes and costs are read in place; no size computed
+ * from the header may overflow. Headers of both versions are supported.
+ * @param[in] header Header to check, completed
+ * @return True iff header is valid
+ */
+static bool binary_header_valid(const BinaryHeader &header) {
+    const uint64_t limit = std::numeric_limits<uint64_t>::max();
+
+    if (memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0
+        || header.version < 1 || header.version > BINARY_VERSION
+        || header.endianness != BINARY_ENDIANNESS
+        || (header.flags & ~BINARY_FLAGS) != 0
+        || !layout_valid(header.size, header.map_size,
+                         header.min_id, header.max_id)) {
+        return false;
+    }
+
+    // Cost matrix fits in memory, and so does the smaller table of nodes
+    const uint64_t nodes_size = header.size * sizeof(BinaryNode),
+                   costs_size = binary_costs_size(header);
+    return header.nodes_offset % sizeof(double) == 0
+        && header.costs_offset % sizeof(double) == 0
+        && header.nodes_offset >= binary_header_size(header)
+        && header.nodes_offset <= limit - nodes_size
+        && header.costs_offset >= header.nodes_offset + nodes_size
+        && header.costs_offset <= limit - costs_size;
+}
+
+
+/**
+ * Writes general data and nodes of an instance as a string.
+ * @param[out] stream   Stream to write to
+ * @param[in]  nodes    Nodes, by dense index
+ * @param[in]  map_size Size of the nodes map
+ * @param[in]  min_id   Minimum identifier
+ * @param[in]  max_id   Maximum identifier
+ */
+static void write_text_head(
+    ostream *stream,
+    const vector<Node> &nodes,
+    const size_t map_size,
+    const unsigned int min_id,
+    const unsigned int max_id) {
+    Writer writer(stream);
+
+    writer.write(static_cast<uint64_t>(nodes.size())).write(' ')
+          .write(static_cast<uint64_t>(map_size)).write(' ')
+          .write(static_cast<uint64_t>(min_id)).write(' ')
+          .write(static_cast<uint64_t>(max_id)).write(' ')
+          .write('\n');
+
+    // Writes every node
+    for (unsigned int i = 0; i < nodes.size(); i++) {
+        nodes[i].save(&writer);
+    }
+    writer.flush();
+}
+
+
+/**
+ * Writes header, nodes and padding of an instance in binary format.
+ * Cost matrix is expected right after.
+ * @param[out] stream   Stream to write to
+ * @param[in]  nodes    Nodes, by dense index
+ * @param[in]  map_size Size of the nodes map
+ * @param[in]  min_id   Minimum identifier
+ * @param[in]  max_id   Maximum identifier
+ * @param[in]  flags    Flags about the cost matrix
+ */
+static void write_binary_head(
+    ostream *stream,
+    const vector<Node> &nodes,
+    const size_t map_size,
+    const unsigned int min_id,
+    const unsigned int max_id,
+    const uint32_t flags) {
+    const size_t size = nodes.size();
+    const uint64_t nodes_size = size * sizeof(BinaryNode),
+                   end        = sizeof(BinaryHeader) + nodes_size,
+                   padding    = (BINARY_ALIGNMENT - end % BINARY_ALIGNMENT)
+                              % BINARY_ALIGNMENT;
+    BinaryHeader header;
+    vector<BinaryNode> table(size);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.version      = BINARY_VERSION;
+    header.endianness   = BINARY_ENDIANNESS;
+    header.size         = size;
+    header.map_size     = map_size;
+    header.min_id       = min_id;
+    header.max_id       = max_id;
+    header.nodes_offset = sizeof(BinaryHeader);
+    header.costs_offset = end + padding;
+    header.flags        = flags;
+
+    for (unsigned int i = 0; i < size; i++) {
+        memset(&table[i], 0, sizeof(BinaryNode));
+        table[i].id = nodes[i].getId();
+        table[i].x  = nodes[i].getX();
+        table[i].y  = nodes[i].getY();
+    }
+
+    // Writes header, nodes and padding
+    const vector<char> zeros(padding, 0);
+    stream->write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (size > 0) {
+        stream->write(reinterpret_cast<const char *>(&table[0]), nodes_size);
+    }
+    if (padding > 0) {
+        stream->write(&zeros[0], padding);
+    }
+}
+
+
+/**
+ * Writes consecutive rows of a cost matrix.
+ * @param[out] stream Stream to write to
+ * @param[in]  costs  Rows, row major
+ * @param[in]  rows   Number of rows
+ * @param[in]  cols   Number of columns
+ * @param[in]  binary Whether to write raw doubles instead of text
+ */
+static void write_rows(
+    ostream *stream,
+    const double *costs,
+    const size_t rows,
+    const size_t cols,
+    const bool binary) {
+    if (!binary) {
+        Writer::writeMatrix(stream, costs, rows, cols);
+        return;
+    }
+
+    stream->write(
+        reinterpret_cast<const char *>(costs),
+        rows * cols * sizeof(double));
+}
+
+
+/**
+ * Writes consecutive rows of the upper triangle of a cost matrix.
+ * Elements from the diagonal onwards only are written, as raw doubles.
+ * @param[out] stream Stream to write to
+ * @param[in]  costs  Whole rows, row major
+ * @param[in]  rows   Number of rows
+ * @param[in]  cols   Number of columns
+ * @param[in]  first  Index of the first row in the matrix
+ */
+static void write_triangle(
+    ostream *stream,
+    const double *costs,
+    const size_t rows,
+    const size_t cols,
+    const size_t first) {
+    for (size_t k = 0; k < rows; k++) {
+        const size_t i = first + k;
+        stream->write(
+            reinterpret_cast<const char *>(costs + k * cols + i),
+            (cols - i) * sizeof(double));
+    }
+}
+
+
+/**
+ * Tells whether a node has a lower identifier than another one.
+ * @param[in] A First node
+ * @param[in] B Second node
+ * @return True iff identifier of A is lower than identifier of B
+ */
+static bool lower_id(const Node &A, const Node &B) {
+    return A.getId() < B.getId();
+}
+
+
 
 /**
  * Returns identifier with the lowest value in a list of nodes.
@@ -88,41 +497,527 @@ unsigned int search_max_id(const vector<Node> &nodes) {
 
 
 
-Instance::Instance(const vector<Node> &nodes, const CostFunction &cost) :
+/**
+ * Reads a whole stream into a buffer.
+ * Buffer is terminated by a null character, which is not part of the
+ * stream.
+ * @param[in]  stream Stream to read from
+ * @param[out] buffer Buffer holding the content of the stream
+ */
+static void read_stream(istream *stream, vector<char> *buffer) {
+    const size_t chunk = 1 << 20;
+    size_t length = 0;
+
+    while (*stream) {
+        if (buffer->size() < length + chunk) {
+            buffer->resize(2 * buffer->size() + chunk);
+        }
+        stream->read(&(*buffer)[length], chunk);
+        length += stream->gcount();
+    }
+
+    buffer->resize(length);
+    buffer->push_back('\0');
+}
+
+
+/** Work shared by threads comparing a matrix with its transpose. */
+struct symmetry_job_s {
+    const double *costs;  ///< Matrix, size x size and row major
+    size_t size;          ///< Number of rows
+    int asymmetric;       ///< Whether a mismatch was found
+};
+
+/** Type of the work shared by threads checking symmetry. */
+typedef struct symmetry_job_s SymmetryJob;
+
+
+/**
+ * Compares a row of tiles of the upper triangle with the matching column
+ * of tiles of the lower one.
+ * Tiles are square, so that both stay in cache; every task stops as soon
+ * as any of them finds a mismatch.
+ * @param[in]      task     Index of the row of tiles
+ * @param[in, out] argument Pointer to the shared job
+ */
+static void symmetry_task(const size_t task, void *argument) {
+    SymmetryJob *job = reinterpret_cast<SymmetryJob *>(argument);
+    const double *costs = job->costs;
+    const size_t N     = job->size,
+                 begin = task * SYMMETRY_TILE,
+                 end   = (begin + SYMMETRY_TILE < N)
+                       ? begin + SYMMETRY_TILE
+                       : N;
+
+    for (size_t j0 = begin; j0 < N; j0 += SYMMETRY_TILE) {
+        const size_t j1 = (j0 + SYMMETRY_TILE < N) ? j0 + SYMMETRY_TILE : N;
+        if (__sync_fetch_and_or(&job->asymmetric, 0)) {
+            return;
+        }
+
+        for (size_t i = begin; i < end; i++) {
+            for (size_t j = (j0 > i) ? j0 : i + 1; j < j1; j++) {
+                if (costs[i * N + j] != costs[j * N + i]) {
+                    __sync_fetch_and_or(&job->asymmetric, 1);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * Tells whether a square matrix is symmetric.
+ * Costs are compared exactly, by tiles and in parallel.
+ * @param[in] costs Matrix, size x size and row major
+ * @param[in] size  Number of rows
+ * @return True iff costs[i][j] is equal to costs[j][i] for every i, j
+ */
+static bool is_symmetric(const double *costs, const size_t size) {
+    SymmetryJob job;
+
+    job.costs      = costs;
+    job.size       = size;
+    job.asymmetric = 0;
+    Parallel::run(
+        (size + SYMMETRY_TILE - 1) / SYMMETRY_TILE,
+        symmetry_task,
+        &job);
+
+    return !job.asymmetric;
+}
+
+
+/**
+ * Releases a cost matrix given to an instance being loaded.
+ * @param[in] costs        Cost matrix
+ * @param[in] mapping      Memory-mapped file containing costs, if any
+ * @param[in] mapping_size Size of the memory-mapped file
+ */
+static void release_costs(
+    double *costs,
+    void *mapping,
+    const size_t mapping_size) {
+    if (mapping != NULL) {
+        munmap(mapping, mapping_size);
+    } else {
+        free(costs);
+    }
+}
+
+
+
+/** Work shared by threads building lists of candidate neighbours. */
+struct candidate_job_s {
+    const Instance *instance;  ///< Instance
+    unsigned int k;            ///< Maximum number of candidates per node
+    int outgoing;              ///< Whether arcs leave or enter nodes
+    unsigned int *list_nodes;  ///< Candidates, k per node
+    double *list_costs;        ///< Costs of the arcs to candidates
+    unsigned int *list_count;  ///< Number of candidates of each node
+};
+
+/** Type of the work shared by threads building candidate lists. */
+typedef struct candidate_job_s CandidateJob;
+
+
+/**
+ * Builds candidate lists of a group of nodes.
+ * @param[in]      task     Index of the task
+ * @param[in, out] argument Pointer to the shared job
+ */
+static void candidate_task(const size_t task, void *argument) {
+    CandidateJob *job = reinterpret_cast<CandidateJob *>(argument);
+    const size_t N     = job->instance->getSize(),
+                 k     = job->k,
+                 begin = task * ROWS_PER_TASK,
+                 end   = (begin + ROWS_PER_TASK < N)
+                       ? begin + ROWS_PER_TASK
+                       : N;
+    vector<unsigned int> nodes(N);
+    vector<double> costs(N);
+    vector< std::pair<double, unsigned int> > arcs;
+
+    arcs.reserve(N);
+    for (size_t i = begin; i < end; i++) {
+        const size_t n = job->outgoing
+            ? job->instance->getOutArcs(i, &nodes[0], &costs[0])
+            : job->instance->getInArcs(i, &nodes[0], &costs[0]);
+
+        arcs.clear();
+        for (size_t a = 0; a < n; a++) {
+            if (nodes[a] != i) {
+                arcs.push_back(std::make_pair(costs[a], nodes[a]));
+            }
+        }
+
+        const size_t m = (arcs.size() < k) ? arcs.size() : k;
+        std::partial_sort(arcs.begin(), arcs.begin() + m, arcs.end());
+        for (size_t a = 0; a < m; a++) {
+            job->list_nodes[i * k + a] = arcs[a].second;
+            job->list_costs[i * k + a] = arcs[a].first;
+        }
+        job->list_count[i] = m;
+    }
+}
+
+
+/**
+ * Builds lists of candidate predecessors of a group of nodes, on a dense
+ * matrix with elements of type T.
+ * Columns of the group are read a row at a time, so that reads are
+ * contiguous whatever the size of the matrix; the cheapest arcs entering
+ * each node are kept in a bounded max-heap on (cost, index) pairs, which
+ * selects the same arcs as candidate_task().
+ * @param[in]      task     Index of the task
+ * @param[in, out] argument Pointer to the shared job
+ */
+template <typename T>
+static void column_task(const size_t task, void *argument) {
+    typedef std::pair<double, unsigned int> Arc;
+    CandidateJob *job = reinterpret_cast<CandidateJob *>(argument);
+    const T *block     = job->instance->getCostBlock<T>();
+    const double scale = job->instance->getCostScale();
+    const size_t N     = job->instance->getSize(),
+                 k     = job->k,
+                 begin = task * COLUMNS_PER_TASK,
+                 end   = (begin + COLUMNS_PER_TASK < N)
+                       ? begin + COLUMNS_PER_TASK
+                       : N;
+    vector< vector<Arc> > heaps(end - begin);
+
+    for (size_t i = 0; i < N; i++) {
+        const T *row = block + i * N;
+        for (size_t j = begin; j < end; j++) {
+            if (row[j] < 0 || i == j) {
+                continue;
+            }
+
+            vector<Arc> &heap = heaps[j - begin];
+            const Arc arc(matrix::Dense<T>::decode(row[j], scale), i);
+            if (heap.size() < k) {
+                heap.push_back(arc);
+                std::push_heap(heap.begin(), heap.end());
+            } else if (arc < heap.front()) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = arc;
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+    }
+
+    for (size_t j = begin; j < end; j++) {
+        vector<Arc> &heap = heaps[j - begin];
+        std::sort_heap(heap.begin(), heap.end());
+        for (size_t a = 0; a < heap.size(); a++) {
+            job->list_nodes[j * k + a] = heap[a].second;
+            job->list_costs[j * k + a] = heap[a].first;
+        }
+        job->list_count[j] = heap.size();
+    }
+}
+
+
+/** Work shared by threads building both candidate lists from rows. */
+struct band_job_s {
+    CandidateJob *successors;                ///< Successors to build
+    CandidateJob *predecessors;              ///< Predecessors to build
+    size_t bands;                            ///< Number of bands of rows
+    std::pair<double, unsigned int> *heaps;  ///< k arcs per band and node
+    unsigned int *heap_count;                ///< Arcs in each heap
+};
+
+/** Type of the work shared by threads building lists from rows. */
+typedef struct band_job_s BandJob;
+
+
+/**
+ * Builds candidate successors of a band of rows, and keeps the cheapest
+ * arcs entering each node from the band in a bounded max-heap on (cost,
+ * index) pairs, as column_task() does, so that every row is read once.
+ * @param[in]      task     Index of the band
+ * @param[in, out] argument Pointer to the shared job
+ */
+static void band_task(const size_t task, void *argument) {
+    typedef std::pair<double, unsigned int> Arc;
+    BandJob *job = reinterpret_cast<BandJob *>(argument);
+    CandidateJob *out = job->successors;
+    const size_t N     = out->instance->getSize(),
+                 k     = out->k,
+                 width = (N + job->bands - 1) / job->bands,
+                 begin = task * width,
+                 end   = (begin + width < N) ? begin + width : N;
+    Arc *heaps = job->heaps + task * N * k;
+    unsigned int *heap_count = job->heap_count + task * N;
+    vector<unsigned int> nodes(N);
+    vector<double> costs(N);
+    vector<Arc> arcs;
+
+    arcs.reserve(N);
+    for (size_t i = begin; i < end; i++) {
+        const size_t n = out->instance->getOutArcs(i, &nodes[0], &costs[0]);
+
+        arcs.clear();
+        for (size_t a = 0; a < n; a++) {
+            const unsigned int j = nodes[a];
+            if (j == i) {
+                continue;
+            }
+            arcs.push_back(std::make_pair(costs[a], j));
+
+            // Arc enters j
+            Arc *heap = heaps + j * k;
+            const Arc arc(costs[a], i);
+            if (heap_count[j] < k) {
+                heap[heap_count[j]++] = arc;
+                std::push_heap(heap, heap + heap_count[j]);
+            } else if (arc < heap[0]) {
+                std::pop_heap(heap, heap + k);
+                heap[k - 1] = arc;
+                std::push_heap(heap, heap + k);
+            }
+        }
+
+        const size_t m = (arcs.size() < k) ? arcs.size() : k;
+        std::partial_sort(arcs.begin(), arcs.begin() + m, arcs.end());
+        for (size_t a = 0; a < m; a++) {
+            out->list_nodes[i * k + a] = arcs[a].second;
+            out->list_costs[i * k + a] = arcs[a].first;
+        }
+        out->list_count[i] = m;
+    }
+}
+
+
+/**
+ * Builds candidate predecessors of a group of nodes, merging the heaps
+ * of every band; ties are broken by index, as in candidate_task().
+ * @param[in]      task     Index of the task
+ * @param[in, out] argument Pointer to the shared job
+ */
+static void merge_task(const size_t task, void *argument) {
+    typedef std::pair<double, unsigned int> Arc;
+    BandJob *job = reinterpret_cast<BandJob *>(argument);
+    CandidateJob *in = job->predecessors;
+    const size_t N     = in->instance->getSize(),
+                 k     = in->k,
+                 begin = task * COLUMNS_PER_TASK,
+                 end   = (begin + COLUMNS_PER_TASK < N)
+                       ? begin + COLUMNS_PER_TASK
+                       : N;
+    vector<Arc> arcs;
+
+    arcs.reserve(job->bands * k);
+    for (size_t j = begin; j < end; j++) {
+        arcs.clear();
+        for (size_t b = 0; b < job->bands; b++) {
+            const Arc *heap = job->heaps + (b * N + j) * k;
+            arcs.insert(arcs.end(), heap, heap + job->heap_count[b * N + j]);
+        }
+
+        const size_t m = (arcs.size() < k) ? arcs.size() : k;
+        std::partial_sort(arcs.begin(), arcs.begin() + m, arcs.end());
+        for (size_t a = 0; a < m; a++) {
+            in->list_nodes[j * k + a] = arcs[a].second;
+            in->list_costs[j * k + a] = arcs[a].first;
+        }
+        in->list_count[j] = m;
+    }
+}
+
+
+/**
+ * Builds candidate successors and predecessors reading every row once.
+ * Rows are split in bands, one task each; every band keeps k arcs per
+ * node, which are merged by groups of columns.
+ * @param[in, out] successors   Candidate successors to build
+ * @param[in, out] predecessors Candidate predecessors to build
+ */
+static void build_from_rows(
+    CandidateJob *successors,
+    CandidateJob *predecessors) {
+    const size_t N     = successors->instance->getSize(),
+                 bands = Parallel::getThreads();
+    vector< std::pair<double, unsigned int> > heaps;
+    vector<unsigned int> heap_count;
+    BandJob job;
+
+    job.successors   = successors;
+    job.predecessors = predecessors;
+    job.bands        = (bands < N) ? bands : N;
+    heaps.resize(job.bands * N * successors->k);
+    heap_count.assign(job.bands * N, 0);
+    job.heaps      = &heaps[0];
+    job.heap_count = &heap_count[0];
+
+    Parallel::run(job.bands, band_task, &job);
+    Parallel::run(
+        (N + COLUMNS_PER_TASK - 1) / COLUMNS_PER_TASK,
+        merge_task,
+        &job);
+}
+
+
+
+/** Work shared by threads computing rows of a cost matrix. */
+struct cost_job_s {
+    const vector<Node> *nodes;  ///< Nodes, by dense index
+    Coordinates targets;        ///< Nodes, as contiguous arrays
+    const CostFunction *cost;   ///< Cost function
+    size_t first;               ///< First row to compute
+    size_t rows;                ///< Number of rows to compute
+    double *costs;              ///< Computed rows, row major
+};
+
+/** Type of the work shared by threads computing a cost matrix. */
+typedef struct cost_job_s CostJob;
+
+
+/**
+ * Computes a group of rows of a cost matrix.
+ * @param[in]      task     Index of the task
+ * @param[in, out] argument Pointer to the shared job
+ */
+static void cost_task(const size_t task, void *argument) {
+    CostJob *job = reinterpret_cast<CostJob *>(argument);
+    const vector<Node> &nodes = *job->nodes;
+    const CostFunction &cost = *job->cost;
+    const size_t N     = nodes.size(),
+                 begin = task * ROWS_PER_TASK,
+                 end   = (begin + ROWS_PER_TASK < job->rows)
+                       ? begin + ROWS_PER_TASK
+                       : job->rows;
+
+    for (size_t i = begin; i < end; i++) {
+        cost.row(nodes[job->first + i], job->targets, job->costs + i * N);
+    }
+}
+
+
+/**
+ * Computes a group of rows of the upper triangle of a cost matrix.
+ * Row i is computed from node i onwards and stored where the triangle
+ * places it.
+ * @param[in]      task     Index of the task
+ * @param[in, out] argument Pointer to the shared job
+ */
+static void triangle_task(const size_t task, void *argument) {
+    CostJob *job = reinterpret_cast<CostJob *>(argument);
+    const vector<Node> &nodes = *job->nodes;
+    const size_t N     = nodes.size(),
+                 begin = task * ROWS_PER_TASK,
+                 end   = (begin + ROWS_PER_TASK < N)
+                       ? begin + ROWS_PER_TASK
+                       : N;
+
+    for (size_t i = begin; i < end; i++) {
+        Coordinates targets = job->targets;
+        targets.id   += i;
+        targets.x    += i;
+        targets.y    += i;
+        targets.size -= i;
+        job->cost->row(
+            nodes[i],
+            targets,
+            job->costs + matrix::Triangular::offset(N, i));
+    }
+}
+
+
+/**
+ * Computes consecutive rows of a cost matrix, in parallel.
+ * Every cost is computed exactly as a serial loop would, a row per call
+ * to the cost function.
+ * @param[in]  nodes   Nodes, by dense index
+ * @param[in]  targets Nodes, as contiguous arrays
+ * @param[in]  cost    Cost function
+ * @param[in]  first First row to compute
+ * @param[in]  rows  Number of rows to compute
+ * @param[out] costs Computed rows, row major
+ */
+static void compute_rows(
+    const vector<Node> &nodes,
+    const Coordinates &targets,
+    const CostFunction &cost,
+    const size_t first,
+    const size_t rows,
+    double *costs) {
+    CostJob job;
+
+    job.nodes   = &nodes;
+    job.targets = targets;
+    job.cost  = &cost;
+    job.first = first;
+    job.rows  = rows;
+    job.costs = costs;
+    Parallel::run((rows + ROWS_PER_TASK - 1) / ROWS_PER_TASK, cost_task, &job);
+}
+
+
+
+Instance::Instance(
+    const vector<Node> &nodes,
+    const CostFunction &cost,
+    const Storage storage,
+    const size_t budget) :
     size(nodes.size()), nodes(nodes),
-    min_id(search_min_id(nodes)), max_id(search_max_id(nodes)) {
+    min_id(search_min_id(nodes)), max_id(search_max_id(nodes)), k(0),
+    function(NULL) {
     map_size = max_id - min_id + 1;
+    symmetric = cost.isSymmetric();
 
-    computeCostMatrix(cost);
+    buildIndex();
+    computeCostMatrix(cost, storage, budget);
 }
 
 
 /**
- * Cost matrix is implemented with direct memory management for performance
- * reasons.
+ * Lazy matrices are built anew on the nodes of the copy, so that copies
+ * never refer to the nodes of the original instance.
  */
 Instance::Instance(const Instance &other) :
     size(other.size), map_size(other.map_size),
-    min_id(other.min_id), max_id(other.max_id) {
-    // Copies nodes
-    nodes = other.nodes;
+    min_id(other.min_id), max_id(other.max_id), k(other.k),
+    successors(other.successors), predecessors(other.predecessors),
+    set(other.set), function(NULL) {
+    // Copies nodes and identifiers map
+    nodes    = other.nodes;
+    index    = other.index;
+    identity = other.identity;
 
     // Copies cost matrix
-    SAFE_MALLOC(costs, double *, map_size * map_size * sizeof(double));
-    memcpy(costs, other.costs, map_size * map_size * sizeof(double));
+    const matrix::Lazy *lazy = dynamic_cast<const matrix::Lazy *>(other.costs);
+    if (lazy != NULL) {
+        if (other.function != NULL) {
+            function = new costFunction::Unfair(*other.function);
+        }
+        costs = new matrix::Lazy(
+            nodes,
+            set.getCoordinates(),
+            (function != NULL) ? *function : lazy->getCostFunction(),
+            lazy->getBudget());
+    } else {
+        costs = other.costs->clone();
+    }
+    dense = costs->getData();
+    precision = other.precision;
+    symmetric = other.symmetric;
 }
 
 
 Instance::~Instance() {
-    free(costs);
+    delete costs;
+    delete function;
 
-    costs = NULL;
+    costs    = NULL;
+    function = NULL;
 }
 
 
 bool
 Instance::hasArc(const unsigned int A, const unsigned int B) const {
-    return costs[(A - min_id) * map_size + (B - min_id)] >= 0;
+    return getCost(A, B) >= 0;
 }
 
 
@@ -132,15 +1027,343 @@ Instance::getSize() const {
 }
 
 
+bool
+Instance::isSymmetric() const {
+    return symmetric;
+}
+
+
 Node &
 Instance::getNode(const unsigned int identifier) const {
-    return const_cast<Node &>(nodes[identifier - min_id]);
+    return const_cast<Node &>(nodes[getIndex(identifier)]);
 }
 
 
 double
 Instance::getCost(const unsigned int A, const unsigned int B) const {
-    return costs[(A - min_id) * map_size + (B - min_id)];
+    const unsigned int i = getIndex(A), j = getIndex(B);
+
+    return (dense != NULL) ? dense[i * size + j] : costs->get(i, j);
+}
+
+
+unsigned int
+Instance::getIndex(const unsigned int identifier) const {
+    return index[identifier - min_id];
+}
+
+
+unsigned int
+Instance::getIdentifier(const unsigned int index) const {
+    return nodes[index].getId();
+}
+
+
+const double *
+Instance::getCostMatrix() const {
+    return dense;
+}
+
+
+template <typename T>
+const T *
+Instance::getCostBlock() const {
+    const matrix::Dense<T> *block =
+        dynamic_cast<const matrix::Dense<T> *>(costs);
+
+    return (block != NULL) ? block->getBlock() : NULL;
+}
+
+
+template const double *Instance::getCostBlock<double>() const;
+template const float *Instance::getCostBlock<float>() const;
+template const int32_t *Instance::getCostBlock<int32_t>() const;
+
+
+const double *
+Instance::getCostTriangle() const {
+    const matrix::Triangular *triangle =
+        dynamic_cast<const matrix::Triangular *>(costs);
+
+    return (triangle != NULL) ? triangle->getBlock() : NULL;
+}
+
+
+const matrix::Matrix &
+Instance::getCosts() const {
+    return *costs;
+}
+
+
+Instance::Storage
+Instance::getStorage() const {
+    if (dynamic_cast<const matrix::Sparse *>(costs) != NULL) {
+        return SPARSE;
+    } else if (dynamic_cast<const matrix::Lazy *>(costs) != NULL) {
+        return LAZY;
+    } else if (dynamic_cast<const matrix::Triangular *>(costs) != NULL) {
+        return TRIANGULAR;
+    }
+
+    return DENSE;
+}
+
+
+/**
+ * Costs are read a row at a time, so that sparse matrices never need
+ * room for every arc.
+ */
+void
+Instance::setStorage(const Storage storage) {
+    const Storage target = (storage == TRIANGULAR && !symmetric)
+                         ? DENSE
+                         : storage;
+    if (target == LAZY || target == getStorage()) {
+        return;
+    }
+
+    matrix::Matrix *converted = NULL;
+    vector<double> row(size);
+    switch (target) {
+    case SPARSE: {
+        matrix::Sparse *sparse = new matrix::Sparse(size);
+        for (size_t i = 0; i < size; i++) {
+            costs->getRow(i, &row[0]);
+            sparse->addRow(&row[0]);
+        }
+        converted = &sparse->close();
+        break;
+    }
+
+    case TRIANGULAR: {
+        double *block;
+        SAFE_MALLOC(block, double *,
+                    size * (size + 1) / 2 * sizeof(double));
+        for (size_t i = 0; i < size; i++) {
+            costs->getRow(i, &row[0]);
+            memcpy(block + matrix::Triangular::offset(size, i), &row[i],
+                   (size - i) * sizeof(double));
+        }
+        converted = new matrix::Triangular(size, block);
+        break;
+    }
+
+    default:
+        converted = new matrix::Dense<double>(*costs, 1.0);
+    }
+
+    delete costs;
+    costs = converted;
+    dense = costs->getData();
+    precision = DOUBLE;
+
+    // Candidates follow the new costs
+    buildCandidates(k);
+}
+
+
+double
+Instance::getCostScale() const {
+    switch (precision) {
+    case FLOAT:
+        return dynamic_cast<const matrix::Dense<float> *>(costs)->getScale();
+    case FIXED:
+        return dynamic_cast<const matrix::Dense<int32_t> *>(costs)->getScale();
+    default:
+        return 1.0;
+    }
+}
+
+
+Instance::Precision
+Instance::getPrecision() const {
+    return precision;
+}
+
+
+/**
+ * Largest cost is found first, in order to choose the scale of fixed
+ * point costs.
+ */
+void
+Instance::setPrecision(const Precision precision) {
+    // Sparse and lazy matrices are kept as they are
+    const bool is_dense = (this->precision != DOUBLE || dense != NULL ||
+                           dynamic_cast<matrix::Triangular *>(costs) != NULL);
+    if (!is_dense || precision == this->precision) {
+        return;
+    }
+
+    matrix::Matrix *converted = NULL;
+    switch (precision) {
+    case DOUBLE:
+        converted = new matrix::Dense<double>(*costs, 1.0);
+        break;
+
+    case FLOAT:
+        converted = new matrix::Dense<float>(*costs, 1.0);
+        break;
+
+    case FIXED: {
+        vector<double> row(size);
+        double max_cost = 0.0;
+        int exponent;
+        for (size_t i = 0; i < size; i++) {
+            costs->getRow(i, &row[0]);
+            for (size_t j = 0; j < size; j++) {
+                max_cost = (row[j] > max_cost) ? row[j] : max_cost;
+            }
+        }
+        frexp(max_cost, &exponent);
+        converted = new matrix::Dense<int32_t>(
+            *costs, ldexp(1.0, 30 - exponent));
+        break;
+    }
+    }
+
+    delete costs;
+    costs = converted;
+    dense = costs->getData();
+    this->precision = precision;
+
+    // Candidates follow the new costs
+    buildCandidates(k);
+}
+
+
+void
+Instance::getCostRow(const unsigned int index, double *row) const {
+    costs->getRow(index, row);
+}
+
+
+size_t
+Instance::getOutArcs(
+    const unsigned int index,
+    unsigned int *targets,
+    double *costs) const {
+    return this->costs->getOutArcs(index, targets, costs);
+}
+
+
+size_t
+Instance::getInArcs(
+    const unsigned int index,
+    unsigned int *sources,
+    double *costs) const {
+    if (symmetric) {
+        return this->costs->getOutArcs(index, sources, costs);
+    }
+
+    return this->costs->getInArcs(index, sources, costs);
+}
+
+
+/**
+ * Candidates are selected with a partial sort on (cost, index) pairs,
+ * a block of nodes per task, or with bounded heaps on dense blocks of
+ * columns. Candidate predecessors of symmetric instances are copied from
+ * candidate successors.
+ */
+void
+Instance::buildCandidates(const unsigned int k) {
+    CandidateJob job;
+
+    this->k = (k < size) ? k : size;
+    job.instance = this;
+    job.k        = this->k;
+    for (job.outgoing = 0; job.outgoing < 2; job.outgoing++) {
+        if (symmetric && !job.outgoing) {
+            continue;
+        }
+        Candidates &list = job.outgoing ? successors : predecessors;
+        list.nodes.assign(size * this->k, 0);
+        list.costs.assign(size * this->k, 0.0);
+        list.count.assign(size, 0);
+        job.list_nodes = list.nodes.empty() ? NULL : &list.nodes[0];
+        job.list_costs = list.costs.empty() ? NULL : &list.costs[0];
+        job.list_count = list.count.empty() ? NULL : &list.count[0];
+        if (this->k == 0) {
+            continue;
+        }
+
+        // Rows of other matrices give both lists at once
+        if (!symmetric && precision == DOUBLE && dense == NULL) {
+            if (job.outgoing) {
+                CandidateJob in = job;
+                in.outgoing   = 0;
+                in.list_nodes = &predecessors.nodes[0];
+                in.list_costs = &predecessors.costs[0];
+                in.list_count = &predecessors.count[0];
+                build_from_rows(&job, &in);
+            }
+            continue;
+        }
+
+        // Predecessors are read from dense blocks by columns
+        Parallel::Task task = candidate_task;
+        size_t width = ROWS_PER_TASK;
+        if (!job.outgoing && (precision != DOUBLE || dense != NULL)) {
+            switch (precision) {
+            case FLOAT:
+                task = column_task<float>;
+                break;
+
+            case FIXED:
+                task = column_task<int32_t>;
+                break;
+
+            default:
+                task = column_task<double>;
+            }
+            width = COLUMNS_PER_TASK;
+        }
+        Parallel::run((size + width - 1) / width, task, &job);
+    }
+
+    if (symmetric) {
+        predecessors = successors;
+    }
+}
+
+
+unsigned int
+Instance::getCandidateCount() const {
+    return k;
+}
+
+
+size_t
+Instance::getOutCandidates(
+    const unsigned int index,
+    const unsigned int **targets,
+    const double **costs) const {
+    if (successors.nodes.empty()) {
+        *targets = NULL;
+        *costs   = NULL;
+        return 0;
+    }
+
+    *targets = &successors.nodes[0] + index * k;
+    *costs   = &successors.costs[0] + index * k;
+    return successors.count[index];
+}
+
+
+size_t
+Instance::getInCandidates(
+    const unsigned int index,
+    const unsigned int **sources,
+    const double **costs) const {
+    if (predecessors.nodes.empty()) {
+        *sources = NULL;
+        *costs   = NULL;
+        return 0;
+    }
+
+    *sources = &predecessors.nodes[0] + index * k;
+    *costs   = &predecessors.costs[0] + index * k;
+    return predecessors.count[index];
 }
 
 
@@ -150,82 +1373,562 @@ Instance::getNodesAsVector() const {
 }
 
 
+/**
+ * Output is buffered and never flushed; cost matrix is formatted in
+ * parallel.
+ */
 Instance &
 Instance::save(ostream *stream) const {
-    *stream << size << " " << map_size << " "
-            << min_id << " " << max_id << " "
-            << std::endl;
+    write_text_head(stream, nodes, map_size, min_id, max_id);
 
-    // Writes every node
-    for (unsigned int i = 0; i < size; i++) {
-        nodes[i].save(stream);
+    // Writes cost matrix, row major
+    if (identity && dense != NULL) {
+        Writer::writeMatrix(stream, dense, map_size, map_size);
+    } else {
+        vector<double> block(ROWS_PER_BLOCK * map_size);
+        for (size_t i = 0; i < map_size; i += ROWS_PER_BLOCK) {
+            const size_t rows = (i + ROWS_PER_BLOCK < map_size)
+                              ? ROWS_PER_BLOCK
+                              : map_size - i;
+            for (size_t k = 0; k < rows; k++) {
+                mapRow(i + k, &block[k * map_size]);
+            }
+            Writer::writeMatrix(stream, &block[0], rows, map_size);
+        }
+    }
+
+    return const_cast<Instance &>(*this);
+}
+
+
+/**
+ * Symmetric costs are saved as the upper triangle of the nodes map.
+ * Lazy instances of unfair cost functions save the parameters of the
+ * function, which are enough to compute every cost again.
+ */
+Instance &
+Instance::saveBinary(ostream *stream) const {
+    const matrix::Lazy *lazy = dynamic_cast<const matrix::Lazy *>(costs);
+    const costFunction::Unfair *unfair = (lazy != NULL)
+        ? dynamic_cast<const costFunction::Unfair *>(&lazy->getCostFunction())
+        : NULL;
+    if (unfair != NULL) {
+        BinaryFunction function;
+        function.p     = unfair->getP();
+        function.mi    = unfair->getMean();
+        function.sigma = unfair->getVariance();
+        function.t     = unfair->getThreshold();
+        function.seed  = unfair->getSeed();
+        write_binary_head(
+            stream, nodes, map_size, min_id, max_id,
+            BINARY_LAZY | (symmetric ? BINARY_SYMMETRIC : 0));
+        stream->write(
+            reinterpret_cast<const char *>(&function), sizeof(function));
+        return const_cast<Instance &>(*this);
+    }
+
+    const uint32_t flags = symmetric
+                         ? BINARY_SYMMETRIC | BINARY_TRIANGULAR
+                         : 0;
+    write_binary_head(stream, nodes, map_size, min_id, max_id, flags);
+
+    // Writes upper triangle, row major
+    if (symmetric) {
+        const matrix::Triangular *triangle =
+            dynamic_cast<const matrix::Triangular *>(costs);
+        if (identity && triangle != NULL) {
+            stream->write(
+                reinterpret_cast<const char *>(triangle->getBlock()),
+                map_size * (map_size + 1) / 2 * sizeof(double));
+            return const_cast<Instance &>(*this);
+        }
+
+        vector<double> row(map_size);
+        for (size_t i = 0; i < map_size; i++) {
+            mapRow(i, &row[0]);
+            write_triangle(stream, &row[0], 1, map_size, i);
+        }
+        return const_cast<Instance &>(*this);
     }
 
     // Writes cost matrix, row major
-    for (unsigned int i = 0; i < map_size; i++) {
-        for (unsigned int j = 0; j < map_size; j++) {
-            *stream << costs[i * map_size + j] << " ";
+    if (identity && dense != NULL) {
+        stream->write(
+            reinterpret_cast<const char *>(dense),
+            map_size * map_size * sizeof(double));
+    } else {
+        vector<double> row(map_size);
+        for (size_t i = 0; i < map_size; i++) {
+            mapRow(i, &row[0]);
+            stream->write(
+                reinterpret_cast<const char *>(&row[0]),
+                map_size * sizeof(double));
         }
-        *stream << std::endl;
     }
 
     return const_cast<Instance &>(*this);
 }
 
 
+/**
+ * Nodes are sorted by identifier, so that a window of consecutive rows
+ * of the nodes map is a window of consecutive sorted nodes; windows are
+ * computed in parallel and written before the next one is computed.
+ * Rows of missing identifiers are infinite. Binary instances of symmetric
+ * cost functions keep the upper triangle only.
+ */
+void
+Instance::write(
+    const vector<Node> &nodes,
+    const CostFunction &cost,
+    ostream *stream,
+    const bool binary) {
+    const size_t size     = nodes.size(),
+                 min_id   = search_min_id(nodes),
+                 max_id   = search_max_id(nodes),
+                 map_size = max_id - min_id + 1,
+                 window   = Parallel::getThreads() * TASKS_PER_THREAD
+                          * ROWS_PER_TASK;
+    vector<Node> sorted(nodes);
+
+    std::stable_sort(sorted.begin(), sorted.end(), lower_id);
+    const NodeSet set(sorted);
+    const Coordinates targets = set.getCoordinates();
+    const bool triangle = binary && cost.isSymmetric();
+
+    if (binary) {
+        write_binary_head(
+            stream, nodes, map_size, min_id, max_id,
+            triangle ? BINARY_SYMMETRIC | BINARY_TRIANGULAR : 0);
+    } else {
+        write_text_head(stream, nodes, map_size, min_id, max_id);
+    }
+
+    // Identifiers are consecutive: rows are written as they are
+    vector<double> rows(window * size);
+    if (map_size == size) {
+        for (size_t first = 0; first < size; first += window) {
+            const size_t n = (first + window < size) ? window : size - first;
+            compute_rows(sorted, targets, cost, first, n, &rows[0]);
+            if (triangle) {
+                write_triangle(stream, &rows[0], n, map_size, first);
+            } else {
+                write_rows(stream, &rows[0], n, map_size, binary);
+            }
+        }
+        return;
+    }
+
+    // Otherwise rows are spread over the nodes map
+    vector<double> block(window * map_size);
+    size_t pending = 0, next = 0, start = 0;
+    for (size_t first = 0; first < size; first += window) {
+        const size_t n = (first + window < size) ? window : size - first;
+        compute_rows(sorted, targets, cost, first, n, &rows[0]);
+        for (size_t i = 0; i < n; i++) {
+            const size_t row = targets.id[first + i] - min_id;
+            for (; next <= row; next++) {
+                double *out = &block[pending * map_size];
+                std::fill(out, out + map_size, CostFunction::infinite);
+                for (size_t j = 0; next == row && j < size; j++) {
+                    out[targets.id[j] - min_id] = rows[i * size + j];
+                }
+                if (++pending == window) {
+                    if (triangle) {
+                        write_triangle(
+                            stream, &block[0], pending, map_size, start);
+                    } else {
+                        write_rows(
+                            stream, &block[0], pending, map_size, binary);
+                    }
+                    start  += pending;
+                    pending = 0;
+                }
+            }
+        }
+    }
+    if (triangle) {
+        write_triangle(stream, &block[0], pending, map_size, start);
+    } else {
+        write_rows(stream, &block[0], pending, map_size, binary);
+    }
+}
+
+
+/**
+ * The whole stream is read at once and parsed by a dedicated parser; the
+ * cost matrix, which is most of the instance, is parsed in parallel.
+ */
 Instance
 Instance::load(istream *stream) {
-    size_t size, map_size;
-    unsigned int min_id, max_id;
+    uint64_t size, map_size, min_id, max_id;
     vector<Node> nodes;
+    vector<char> buffer;
     double *costs;
 
+    // Binary instances start with a magic string
+    if (stream->peek() == BINARY_MAGIC[0]) {
+        return loadBinary(stream);
+    }
+
+    read_stream(stream, &buffer);
+    const char *end = &buffer[0] + buffer.size() - 1;
+    Parser parser(&buffer[0], end);
+
     // Reads general data
-    *stream >> size >> map_size >> min_id >> max_id;
+    if (!parser.parse(&size) || !parser.parse(&map_size) ||
+        !parser.parse(&min_id) || !parser.parse(&max_id) ||
+        !layout_valid(size, map_size, min_id, max_id)) {
+        IO_ERROR("<stream>", "Invalid instance.");
+    }
 
     // Reads data about nodes
+    nodes.reserve(size);
     for (unsigned int i = 0; i < size; i++) {
-        nodes.push_back(Node::load(stream));
+        uint64_t id;
+        double x, y;
+        if (!parser.parse(&id) || !parser.parse(&x) || !parser.parse(&y)) {
+            IO_ERROR("<stream>", "Truncated instance.");
+        }
+        if (id < min_id || id > max_id) {
+            IO_ERROR("<stream>", "Invalid instance.");
+        }
+        nodes.push_back(Node(id, x, y));
     }
 
     // Reads data about cost
-    SAFE_MALLOC(costs, double *, map_size * map_size * sizeof(double));
-    for (unsigned int i = 0; i < map_size; i++) {
-        for (unsigned int j = 0; j < map_size; j++) {
-            *stream >> costs[i * map_size + j];
-        }
+    const size_t count = map_size * map_size;
+    SAFE_MALLOC(costs, double *, count * sizeof(double));
+    if (Parser::parseAll(parser.getPosition(), end, costs, count) < count) {
+        IO_ERROR("<stream>", "Truncated instance.");
     }
 
-    Instance instance(nodes, map_size, costs);
-    free(costs);
+    return Instance(nodes, map_size, costs, UNKNOWN);
+}
+
+
+/**
+ * The file is mapped privately: pages are loaded on demand and shared with
+ * the page cache, so that the cost matrix is never copied.
+ */
+Instance
+Instance::open(const char *path) {
+    BinaryHeader header;
+    struct stat info;
+    const int fd = ::open(path, O_RDONLY);
+
+    if (fd < 0 || fstat(fd, &info) < 0) {
+        IO_ERROR(path, "Cannot open file.");
+    }
 
-    return instance;
+    // Text instances are parsed
+    if (static_cast<size_t>(info.st_size) < sizeof(header) ||
+        pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+        memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+        close(fd);
+        std::ifstream file(path);
+        return load(&file);
+    }
+    binary_header_complete(&header);
+
+    // Binary instances are mapped
+    const size_t length = info.st_size;
+    // Table of nodes comes before costs_offset, as checked by the header
+    if (!binary_header_valid(header) ||
+        length < header.costs_offset ||
+        length - header.costs_offset < binary_costs_size(header)) {
+        IO_ERROR(path, "Invalid binary instance.");
+    }
+
+    void *mapping = mmap(
+        NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        IO_ERROR(path, "Cannot map file.");
+    }
+    // Only the table of nodes is read at once, costs are paged on demand
+    madvise(mapping, header.costs_offset, MADV_WILLNEED);
+
+    const char *base = reinterpret_cast<const char *>(mapping);
+    const BinaryNode *table =
+        reinterpret_cast<const BinaryNode *>(base + header.nodes_offset);
+    vector<Node> nodes;
+    nodes.reserve(header.size);
+    for (unsigned int i = 0; i < header.size; i++) {
+        nodes.push_back(Node(table[i].id, table[i].x, table[i].y));
+    }
+    if (!nodes_valid(nodes, header.min_id, header.max_id)) {
+        munmap(mapping, length);
+        IO_ERROR(path, "Invalid binary instance.");
+    }
+
+    // Cost functions are read, costs are computed on demand
+    if (header.flags & BINARY_LAZY) {
+        BinaryFunction function;
+        memcpy(&function, base + header.costs_offset, sizeof(function));
+        munmap(mapping, length);
+        return Instance(nodes, unfair_create(function, path));
+    }
+
+    // Symmetry is known from the header since version 2
+    const Symmetry symmetry = (header.flags & BINARY_TRIANGULAR) ? TRIANGLE
+                            : (header.flags & BINARY_SYMMETRIC)  ? SYMMETRIC
+                            : (header.version < 2)               ? UNKNOWN
+                                                                 : ASYMMETRIC;
+    double *costs = reinterpret_cast<double *>(
+        static_cast<char *>(mapping) + header.costs_offset);
+    return Instance(
+        nodes, header.map_size, costs, symmetry, mapping, length);
 }
 
 
+/**
+ * Symmetric matrices are stored as triangles: triangles stored on disk
+ * are used as they are when indices and identifiers coincide, other
+ * matrices are compacted into a new triangle.
+ */
 Instance::Instance(
-    const vector<Node> nodes,
+    const vector<Node> &nodes,
     const size_t map_size,
-    const double *costs) :
+    double *costs,
+    const Symmetry symmetry,
+    void *mapping,
+    const size_t mapping_size) :
     size(nodes.size()), nodes(nodes), map_size(map_size),
-    min_id(search_min_id(nodes)), max_id(search_max_id(nodes)) {
-    SAFE_MALLOC(this->costs, double *, map_size * map_size * sizeof(double));
-    memcpy(this->costs, costs, map_size * map_size * sizeof(double));
+    min_id(search_min_id(nodes)), max_id(search_max_id(nodes)), k(0),
+    function(NULL) {
+    buildIndex();
+    precision = DOUBLE;
+    dense     = NULL;
+    symmetric = (symmetry == TRIANGLE || symmetry == SYMMETRIC)
+             || (symmetry == UNKNOWN && is_symmetric(costs, map_size));
+
+    if (symmetry == TRIANGLE && identity) {
+        this->costs = new matrix::Triangular(
+            size, costs, mapping, mapping_size);
+        return;
+    }
+
+    if (symmetry != TRIANGLE && !symmetric && identity) {
+        this->costs = new matrix::Dense<double>(
+            size, costs, 1.0, mapping, mapping_size);
+        dense = costs;
+        return;
+    }
+
+    // Compacts the cost matrix, following the order of nodes
+    double *compact;
+    if (symmetric) {
+        SAFE_MALLOC(compact, double *,
+                    size * (size + 1) / 2 * sizeof(double));
+    } else {
+        SAFE_MALLOC(compact, double *, size * size * sizeof(double));
+    }
+    for (size_t i = 0; i < size; i++) {
+        const size_t row = nodes[i].getId() - min_id;
+        for (size_t j = symmetric ? i : 0; j < size; j++) {
+            const size_t col = nodes[j].getId() - min_id,
+                         low  = (row < col) ? row : col,
+                         high = (row < col) ? col : row;
+            const double cost = (symmetry == TRIANGLE)
+                ? costs[matrix::Triangular::offset(map_size, low)
+                        + (high - low)]
+                : costs[row * map_size + col];
+            if (symmetric) {
+                compact[matrix::Triangular::offset(size, i) + (j - i)] = cost;
+            } else {
+                compact[i * size + j] = cost;
+            }
+        }
+    }
+
+    release_costs(costs, mapping, mapping_size);
+    if (symmetric) {
+        this->costs = new matrix::Triangular(size, compact);
+    } else {
+        this->costs = new matrix::Dense<double>(size, compact);
+        dense = compact;
+    }
+}
+
+
+Instance::Instance(
+    const vector<Node> &nodes,
+    const costFunction::Unfair *function) :
+    size(nodes.size()), nodes(nodes),
+    min_id(search_min_id(nodes)), max_id(search_max_id(nodes)), k(0),
+    function(function) {
+    map_size = max_id - min_id + 1;
+    symmetric = function->isSymmetric();
+
+    buildIndex();
+    computeCostMatrix(*function, LAZY, CACHE_BUDGET);
+}
+
+
+/**
+ * Used when the instance comes from a stream which cannot be mapped: cost
+ * matrix is read directly into its final buffer.
+ */
+Instance
+Instance::loadBinary(istream *stream) {
+    BinaryHeader header;
+    vector<BinaryNode> table;
+    vector<Node> nodes;
+    double *costs;
+
+    // Reads header, flags only since version 2
+    const size_t common = offsetof(BinaryHeader, flags);
+    char *bytes = reinterpret_cast<char *>(&header);
+    stream->read(bytes, common);
+    if (*stream && header.version >= 2) {
+        stream->read(bytes + common, sizeof(header) - common);
+    }
+    binary_header_complete(&header);
+    if (!*stream || !binary_header_valid(header)) {
+        IO_ERROR("<stream>", "Invalid binary instance.");
+    }
+
+    // Reads data about nodes
+    table.resize(header.size);
+    stream->ignore(header.nodes_offset - binary_header_size(header));
+    if (header.size > 0) {
+        stream->read(
+            reinterpret_cast<char *>(&table[0]),
+            header.size * sizeof(BinaryNode));
+    }
+    for (unsigned int i = 0; i < header.size; i++) {
+        nodes.push_back(Node(table[i].id, table[i].x, table[i].y));
+    }
+    if (!*stream || !nodes_valid(nodes, header.min_id, header.max_id)) {
+        IO_ERROR("<stream>", "Invalid binary instance.");
+    }
+
+    // Reads data about cost
+    stream->ignore(
+        header.costs_offset - header.nodes_offset
+                            - header.size * sizeof(BinaryNode));
+    if (header.flags & BINARY_LAZY) {
+        BinaryFunction function;
+        stream->read(reinterpret_cast<char *>(&function), sizeof(function));
+        if (!*stream) {
+            IO_ERROR("<stream>", "Truncated binary instance.");
+        }
+        return Instance(nodes, unfair_create(function, "<stream>"));
+    }
+
+    const size_t length = binary_costs_size(header);
+    SAFE_MALLOC(costs, double *, length);
+    stream->read(reinterpret_cast<char *>(costs), length);
+    if (!*stream) {
+        IO_ERROR("<stream>", "Truncated binary instance.");
+    }
+
+    // Symmetry is known from the header since version 2
+    const Symmetry symmetry = (header.flags & BINARY_TRIANGULAR) ? TRIANGLE
+                            : (header.flags & BINARY_SYMMETRIC)  ? SYMMETRIC
+                            : (header.version < 2)               ? UNKNOWN
+                                                                 : ASYMMETRIC;
+    return Instance(nodes, header.map_size, costs, symmetry);
 }
 
 
 /**
  * Cost matrix is implemented with direct memory management for performance
- * reasons.
+ * reasons. Rows are computed in parallel.
+ * Sparse matrices are built a window of rows at a time, so that the
+ * complete matrix is never held in memory. Lazy matrices compute nothing
+ * here. Triangular matrices compute half of the arcs only.
  */
 void
-Instance::computeCostMatrix(const CostFunction &cost) {
-    SAFE_MALLOC(costs, double *, map_size * map_size * sizeof(double));
-    for (size_t i = 0; i < size; i++) {
-        const unsigned int id_i = nodes[i].getId() - min_id;
-        for (size_t j = 0; j < size; j++) {
-            const unsigned int id_j = nodes[j].getId() - min_id;
-            costs[id_i * map_size + id_j] = cost(nodes[id_i], nodes[id_j]);
+Instance::computeCostMatrix(
+    const CostFunction &cost,
+    const Storage storage,
+    const size_t budget) {
+    if (storage == LAZY) {
+        set   = NodeSet(nodes);
+        costs = new matrix::Lazy(nodes, set.getCoordinates(), cost, budget);
+        dense = NULL;
+        precision = DOUBLE;
+        return;
+    }
+
+    const NodeSet arrays(nodes);
+    const Coordinates targets = arrays.getCoordinates();
+
+    if (storage == TRIANGULAR && symmetric) {
+        CostJob job;
+        double *block;
+        SAFE_MALLOC(block, double *, size * (size + 1) / 2 * sizeof(double));
+        job.nodes   = &nodes;
+        job.targets = targets;
+        job.cost    = &cost;
+        job.first   = 0;
+        job.rows    = size;
+        job.costs   = block;
+        Parallel::run(
+            (size + ROWS_PER_TASK - 1) / ROWS_PER_TASK,
+            triangle_task,
+            &job);
+        costs = new matrix::Triangular(size, block);
+        dense = NULL;
+        precision = DOUBLE;
+        return;
+    }
+
+    if (storage == SPARSE) {
+        const size_t window = Parallel::getThreads() * TASKS_PER_THREAD
+                            * ROWS_PER_TASK;
+        matrix::Sparse *sparse = new matrix::Sparse(size);
+        vector<double> rows(window * size);
+        for (size_t first = 0; first < size; first += window) {
+            const size_t n = (first + window < size) ? window : size - first;
+            compute_rows(nodes, targets, cost, first, n, &rows[0]);
+            for (size_t i = 0; i < n; i++) {
+                sparse->addRow(&rows[i * size]);
+            }
         }
+        costs = &sparse->close();
+        dense = NULL;
+        precision = DOUBLE;
+        return;
+    }
+
+    double *block;
+    SAFE_MALLOC(block, double *, size * size * sizeof(double));
+    compute_rows(nodes, targets, cost, 0, size, block);
+    costs = new matrix::Dense<double>(size, block);
+    dense = block;
+    precision = DOUBLE;
+}
+
+
+void
+Instance::buildIndex() {
+    index.assign(map_size, NO_INDEX);
+    identity = (map_size == size);
+
+    for (unsigned int i = 0; i < size; i++) {
+        const unsigned int offset = nodes[i].getId() - min_id;
+        index[offset] = i;
+        identity = identity && (offset == i);
+    }
+}
+
+
+void
+Instance::mapRow(const size_t row, double *out) const {
+    const unsigned int i = index[row];
+    vector<double> costs(size);
+
+    if (i != NO_INDEX) {
+        getCostRow(i, &costs[0]);
+    }
+
+    for (size_t col = 0; col < map_size; col++) {
+        const unsigned int j = index[col];
+        out[col] = (i != NO_INDEX && j != NO_INDEX)
+                 ? costs[j]
+                 : CostFunction::infinite;
     }
 }
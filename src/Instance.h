@@ -22,7 +22,10 @@
 #include <ostream>
 
 #include "Node.h"
+#include "NodeSet.h"
 #include "costFunction/CostFunction.h"
+#include "costFunction/Unfair.h"
+#include "matrix/Matrix.h"
 
 using std::vector;
 using std::istream;
@@ -34,17 +37,57 @@ using costFunction::CostFunction;
  * Istances have a list of nodes and a matrix of costs among them.
  * Since no assumption is made on the cost of the arcs, matrix is
  * complete.
+ * Besides their identifiers, nodes are known by a dense index, from 0 to
+ * size - 1, following the order in which they were given. Cost matrix is
+ * stored by index, so that solvers can use it directly.
+ * Cost matrix is either dense or sparse; sparse matrices store existing
+ * arcs only, and arcs can be scanned in time proportional to their number.
+ * Costs may also be computed on demand, within a memory budget, when the
+ * matrix does not fit in memory.
+ * Dense matrices may store costs with reduced precision, in order to save
+ * memory and bandwidth; costs are always returned as doubles.
+ * Instances know whether their costs are symmetric, either from the cost
+ * function or by inspecting the matrix: symmetric costs may be stored as
+ * an upper triangle, and arcs entering a node are the ones leaving it.
  *
  * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
  */
 class Instance {
  public:
+    /** Storage of the cost matrix. */
+    enum Storage {
+        DENSE,       ///< Every arc is stored in a contiguous block
+        SPARSE,      ///< Existing arcs only are stored, by row and by column
+        LAZY,        ///< Costs are computed on demand, recent rows are cached
+        TRIANGULAR   ///< Upper triangle only, for symmetric costs
+    };
+
+    /** Default memory budget for lazy cost matrices, in bytes. */
+    static const size_t CACHE_BUDGET = 256 * 1024 * 1024;
+
+    /** Type of the elements of a dense cost matrix. */
+    enum Precision {
+        DOUBLE,  ///< Costs are stored as doubles
+        FLOAT,   ///< Costs are stored as floats
+        FIXED    ///< Costs are scaled and rounded to 32 bits integers
+    };
+
+
     /**
      * Constructor.
-     * @param[in] nodes Nodes in the instance
-     * @param[in] cost  Function telling costs among nodes
+     * @param[in] nodes   Nodes in the instance
+     * @param[in] cost    Function telling costs among nodes
+     * @param[in] storage Storage of the cost matrix
+     * @param[in] budget  Memory for cached costs, in bytes, if lazy
+     * @note With lazy storage, cost function must outlive the instance
+     * @note Triangular storage falls back to dense storage when cost
+     *       function is not symmetric
      */
-    Instance(const vector<Node> &nodes, const CostFunction &cost);
+    Instance(
+        const vector<Node> &nodes,
+        const CostFunction &cost,
+        const Storage storage = DENSE,
+        const size_t budget = CACHE_BUDGET);
 
 
     /**
@@ -74,6 +117,15 @@ class Instance {
      */
     size_t getSize() const;
 
+    /**
+     * Tells whether cost of every arc is equal to cost of its reverse.
+     * Instances built from a cost function trust the function; binary
+     * instances trust their header, while text instances and binary
+     * instances of version 1 compare the two halves of the matrix.
+     * @return True iff cost matrix is symmetric
+     */
+    bool isSymmetric() const;
+
     /**
      * Returns node with given identifier.
      * @param[in] identifier Identifier of a node
@@ -89,8 +141,177 @@ class Instance {
      */
     double getCost(const unsigned int A, const unsigned int B) const;
 
+    /**
+     * Returns dense index of node with given identifier.
+     * @param[in] identifier Identifier of a node
+     * @return Index of the node, from 0 to size - 1
+     */
+    unsigned int getIndex(const unsigned int identifier) const;
+
+    /**
+     * Returns identifier of node with given dense index.
+     * @param[in] index Index of a node, from 0 to size - 1
+     * @return Identifier of the node
+     */
+    unsigned int getIdentifier(const unsigned int index) const;
+
+    /**
+     * Returns the cost matrix.
+     * Matrix is size x size, row major, and is addressed by dense index:
+     * cost of arc (i, j) is at position i * size + j.
+     * @return Pointer to the cost matrix, NULL if matrix is not dense
+     */
+    const double *getCostMatrix() const;
+
+    /**
+     * Returns the cost matrix as stored.
+     * Matrix is size x size, row major, and is addressed by dense index.
+     * Stored elements are costs multiplied by getCostScale(); missing
+     * arcs are negative.
+     * @return Pointer to the cost matrix, NULL if matrix is not dense or
+     *         its elements are not of type T
+     */
+    template <typename T>
+    const T *getCostBlock() const;
+
+    /**
+     * Returns the cost matrix as a triangle.
+     * Upper triangle is stored row by row: row i starts at
+     * matrix::Triangular::offset(size, i), with the cost of arc (i, i).
+     * @return Pointer to the upper triangle, NULL if matrix is not
+     *         triangular
+     */
+    const double *getCostTriangle() const;
+
+    /**
+     * Returns the cost matrix, whatever its storage.
+     * Matrix is addressed by dense index.
+     * @return Cost matrix
+     */
+    const matrix::Matrix &getCosts() const;
+
+    /**
+     * Returns the storage of the cost matrix.
+     * @return Storage of the cost matrix
+     */
+    Storage getStorage() const;
+
+    /**
+     * Changes the storage of the cost matrix.
+     * Costs are copied a row at a time; dense matrices only keep their
+     * type of elements when their storage does not change, other
+     * storages keep doubles. Triangular storage falls back to dense
+     * storage when costs are not symmetric. Lazy storage needs a cost
+     * function, so that no matrix is converted to it.
+     * @param[in] storage Storage of the cost matrix
+     */
+    void setStorage(const Storage storage);
+
+    /**
+     * Returns the scale factor of the stored costs.
+     * @return Scale factor of the stored costs
+     */
+    double getCostScale() const;
+
+    /**
+     * Returns the type of the elements of the cost matrix.
+     * @return Type of the elements of the cost matrix
+     */
+    Precision getPrecision() const;
+
+    /**
+     * Changes the type of the elements of the cost matrix.
+     * Only dense and triangular matrices are converted, into dense ones.
+     * Fixed point costs are scaled by a power of two, so that the largest
+     * cost takes 30 bits.
+     * Costs are converted from the current storage: lost precision is
+     * not recovered.
+     * @param[in] precision Type of the elements of the cost matrix
+     */
+    void setPrecision(const Precision precision);
+
+    /**
+     * Returns costs of every arc leaving a node.
+     * Missing arcs have infinite cost.
+     * @param[in]  index Dense index of the node
+     * @param[out] row   Costs of the arcs, by dense index, size elements
+     */
+    void getCostRow(const unsigned int index, double *row) const;
+
+    /**
+     * Returns existing arcs leaving a node.
+     * Arcs are sorted by target. Time is proportional to the number of
+     * existing arcs for sparse matrices, to size for dense ones.
+     * @param[in]  index   Dense index of the node
+     * @param[out] targets Dense indices of targets, up to size elements
+     * @param[out] costs   Costs of the arcs, up to size elements
+     * @return Number of arcs leaving the node
+     */
+    size_t getOutArcs(
+        const unsigned int index,
+        unsigned int *targets,
+        double *costs) const;
+
+    /**
+     * Returns existing arcs entering a node.
+     * Arcs are sorted by source. Time is proportional to the number of
+     * existing arcs for sparse matrices, to size for dense ones; the row
+     * of the node is scanned when costs are symmetric.
+     * @param[in]  index   Dense index of the node
+     * @param[out] sources Dense indices of sources, up to size elements
+     * @param[out] costs   Costs of the arcs, up to size elements
+     * @return Number of arcs entering the node
+     */
+    size_t getInArcs(
+        const unsigned int index,
+        unsigned int *sources,
+        double *costs) const;
+
+    /**
+     * Builds lists of candidate neighbours.
+     * For each node, the k cheapest arcs leaving it and the k cheapest
+     * arcs entering it are kept, sorted by cost (ties by index). Loops
+     * and missing arcs are never candidates. Lists are built in parallel;
+     * on dense matrices, candidate predecessors are taken from blocks of
+     * columns read a row at a time, so that reads stay contiguous; on
+     * other matrices, both lists are taken from a single scan of rows.
+     * @param[in] k Maximum number of candidates per node, 0 drops lists
+     */
+    void buildCandidates(const unsigned int k);
+
+    /**
+     * Returns maximum number of candidate neighbours per node.
+     * @return Maximum number of candidates, 0 if lists were not built
+     */
+    unsigned int getCandidateCount() const;
+
+    /**
+     * Returns candidate successors of a node.
+     * @param[in]  index   Dense index of the node
+     * @param[out] targets Dense indices of the candidates, by cost
+     * @param[out] costs   Costs of the arcs to the candidates
+     * @return Number of candidates
+     */
+    size_t getOutCandidates(
+        const unsigned int index,
+        const unsigned int **targets,
+        const double **costs) const;
+
+    /**
+     * Returns candidate predecessors of a node.
+     * @param[in]  index   Dense index of the node
+     * @param[out] sources Dense indices of the candidates, by cost
+     * @param[out] costs   Costs of the arcs from the candidates
+     * @return Number of candidates
+     */
+    size_t getInCandidates(
+        const unsigned int index,
+        const unsigned int **sources,
+        const double **costs) const;
+
     /**
      * Returns the list of nodes as a vector.
+     * Nodes are sorted by dense index.
      * @return Nodes as a vector
      */
     vector<Node> getNodesAsVector() const;
@@ -104,40 +325,162 @@ class Instance {
     Instance &save(ostream *stream) const;
 
 
+    /**
+     * Saves this instance in binary format.
+     * Binary instances are made of a header, a table of nodes and the
+     * raw cost matrix, aligned to a page boundary so that it can be
+     * memory-mapped. Header tells whether costs are symmetric, in which
+     * case the upper triangle of the matrix only is saved.
+     * Instances computing costs on demand by an unfair cost function save
+     * the parameters of the function instead of the cost matrix, so that
+     * they are loaded with lazy storage.
+     * @param[out] stream Stream on which save this instance
+     * @return This instance itself
+     */
+    Instance &saveBinary(ostream *stream) const;
+
+
+    /**
+     * Writes an instance without building it.
+     * Rows of the cost matrix are computed in parallel, a window at a
+     * time, and written as soon as they are ready: memory is
+     * proportional to the number of nodes, never to the size of the cost
+     * matrix. Output is the same as building the instance and saving it.
+     * @param[in]  nodes  Nodes in the instance
+     * @param[in]  cost   Function telling costs among nodes
+     * @param[out] stream Stream on which write the instance
+     * @param[in]  binary Whether to use the binary format
+     */
+    static void write(
+        const vector<Node> &nodes,
+        const CostFunction &cost,
+        ostream *stream,
+        const bool binary = false);
+
+
     /**
      * Loads an instance from a string.
+     * Binary instances are recognized and loaded as well.
      * @param[in] stream Stream to read from
      * @return An instance read from the stream
      */
     static Instance load(istream *stream);
 
 
+    /**
+     * Loads an instance from a file.
+     * Binary instances are memory-mapped, so that cost matrix is neither
+     * parsed nor copied; text instances are parsed as in load. Binary
+     * instances saving a cost function compute costs on demand, within
+     * the default memory budget.
+     * @param[in] path Path of the file to read from
+     * @return An instance read from the file
+     */
+    static Instance open(const char *path);
+
+
  private:
-    const size_t size;      ///< Number of nodes in this instance
-    vector<Node> nodes;     ///< Nodes in this instance
-    size_t map_size;        ///< Size of the nodes map
-    const unsigned min_id;  ///< Minimum identifier
-    const unsigned max_id;  ///< Maximum identifier
-    double* costs;          ///< Cost matrix
+    /** What is known about the symmetry of a cost matrix being loaded. */
+    enum Symmetry {
+        UNKNOWN,     ///< Matrix has to be inspected
+        ASYMMETRIC,  ///< Matrix is not known to be symmetric
+        SYMMETRIC,   ///< Matrix is symmetric
+        TRIANGLE     ///< Matrix is symmetric, upper triangle only
+    };
+
+    /** Candidate neighbours of every node, k slots per node. */
+    struct Candidates {
+        vector<unsigned> nodes;  ///< Dense indices of the candidates
+        vector<double> costs;    ///< Costs of the arcs
+        vector<unsigned> count;  ///< Number of candidates of each node
+    };
+
+
+    const size_t size;       ///< Number of nodes in this instance
+    vector<Node> nodes;      ///< Nodes in this instance
+    size_t map_size;         ///< Size of the nodes map
+    const unsigned min_id;   ///< Minimum identifier
+    const unsigned max_id;   ///< Maximum identifier
+    vector<unsigned> index;  ///< Dense index of each identifier
+    bool identity;           ///< Whether index is identifier - min_id
+    matrix::Matrix *costs;   ///< Cost matrix, by dense index
+    const double *dense;     ///< Cost matrix as a block, if dense
+    Precision precision;     ///< Type of the elements of the cost matrix
+    bool symmetric;          ///< Whether cost matrix is symmetric
+    unsigned int k;           ///< Candidate neighbours per node
+    Candidates successors;    ///< Candidate successors of every node
+    Candidates predecessors;  ///< Candidate predecessors of every node
+    NodeSet set;                           ///< Nodes as arrays, if lazy
+    const costFunction::Unfair *function;  ///< Cost function, if owned
 
 
     /**
      * Constructs an instance with given nodes and costs.
-     * @param[in] nodes    Nodes in the instance
-     * @param[in] map_size Size of the internal map structure
-     * @param[in] costs    Cost matrix
+     * Instance takes ownership of the cost matrix: it is released with
+     * free or, when a mapping is given, by unmapping the whole mapping.
+     * Cost matrix is map_size x map_size, or its upper triangle, and
+     * addressed by identifier; it is compacted unless indices and
+     * identifiers coincide. Symmetric matrices are kept as triangles.
+     * @param[in] nodes        Nodes in the instance
+     * @param[in] map_size     Size of the internal map structure
+     * @param[in] costs        Cost matrix
+     * @param[in] symmetry     What is known about symmetry of costs
+     * @param[in] mapping      Memory-mapped file containing costs, if any
+     * @param[in] mapping_size Size of the memory-mapped file
      */
     Instance(
-        const vector<Node> nodes,
+        const vector<Node> &nodes,
         const size_t map_size,
-        const double *costs);
+        double *costs,
+        const Symmetry symmetry,
+        void *mapping = NULL,
+        const size_t mapping_size = 0);
+
+
+    /**
+     * Constructs an instance computing its costs on demand.
+     * Instance takes ownership of the cost function, which it deletes.
+     * @param[in] nodes    Nodes in the instance
+     * @param[in] function Function telling costs among nodes
+     */
+    Instance(
+        const vector<Node> &nodes,
+        const costFunction::Unfair *function);
+
+
+    /**
+     * Loads an instance in binary format from a stream.
+     * @param[in] stream Stream to read from
+     * @return An instance read from the stream
+     */
+    static Instance loadBinary(istream *stream);
 
 
     /**
      * Builds cost matrix using given cost function.
-     * @param[in] cost Cost function to use
+     * @param[in] cost    Cost function to use
+     * @param[in] storage Storage of the cost matrix
+     * @param[in] budget  Memory for cached costs, in bytes, if lazy
+     */
+    void computeCostMatrix(
+        const CostFunction &cost,
+        const Storage storage,
+        const size_t budget);
+
+
+    /**
+     * Builds the map from identifiers to dense indices.
+     */
+    void buildIndex();
+
+
+    /**
+     * Returns a row of the cost matrix, addressed by identifier.
+     * Arcs from or to missing identifiers are infinite.
+     * @param[in]  row Identifier of the row, minus min_id
+     * @param[out] out Row of map_size costs
      */
-    void computeCostMatrix(const CostFunction &cost);
+    void mapRow(const size_t row, double *out) const;
 };
 
 #endif  // INSTANCE_H_
@@ -14,16 +14,10 @@
  * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Node.h"
+#include "Writer.h"
 
-unsigned int Node::last_id = 0;
-
-Node::Node(const double x, const double y):
-    identifier(++last_id), x(x), y(y) {
-}
-
-Node
-Node::operator=(const Node &other) {
-    return Node(other);
+Node::Node(const unsigned int id, const double x, const double y):
+    identifier(id), x(x), y(y) {
 }
 
 
@@ -45,7 +39,17 @@ Node::getY() const {
 
 Node &
 Node::save(ostream *stream) const {
-    *stream << identifier << " " << x << " " << y << std::endl;
+    Writer writer(stream, 64);
+
+    return save(&writer);
+}
+
+
+Node &
+Node::save(Writer *writer) const {
+    writer->write(static_cast<uint64_t>(identifier)).write(' ')
+           .write(x).write(' ')
+           .write(y).write('\n');
 
     return const_cast<Node &>(*this);
 }
@@ -59,8 +63,3 @@ Node::load(istream *stream) {
     *stream >> id >> x >> y;
     return Node(id, x, y);
 }
-
-
-Node::Node(const unsigned int id, const double x, const double y):
-    identifier(id), x(x), y(y) {
-}
@@ -22,9 +22,15 @@
 using std::istream;
 using std::ostream;
 
+class Writer;
+
 /**
  * A node in the Traveling Salesman Problem graph.
  * Nodes represent holes in a panel.
+ * Nodes are plain records, copied and assigned member by member, so that
+ * they can be stored in arrays and moved around freely. Identifiers are
+ * always given explicitly: new nodes get them from the NodeSet they are
+ * added to, so that no global state is involved.
  *
  * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
  */
@@ -32,17 +38,11 @@ class Node {
  public:
     /**
      * Constructor.
-     * @param[in] x X-coordinate
-     * @param[in] y Y-coordinate
-     */
-    Node(const double x, const double y);
-
-
-    /**
-     * Assignment operator
-     * @param[in] other Other node
+     * @param[in] id Identifier of the node
+     * @param[in] x  X-coordinate
+     * @param[in] y  Y-coordinate
      */
-    Node operator=(const Node &other);
+    Node(const unsigned int id, const double x, const double y);
 
 
     /**
@@ -71,6 +71,13 @@ class Node {
      */
     Node &save(ostream *stream) const;
 
+    /**
+     * Saves this node as a string.
+     * @param[out] writer Writer on which save this node
+     * @return This node itself
+     */
+    Node &save(Writer *writer) const;
+
 
     /**
      * Loads a node from a string.
@@ -81,19 +88,9 @@ class Node {
 
 
  private:
-    static unsigned int last_id;
     unsigned int identifier;  ///< Identifier of this node
-    const double x;           ///< X-coordinate of this node
-    const double y;           ///< Y-coordinate of this node
-
-
-    /**
-     * Constructor.
-     * @param[in] id Identifier of the node
-     * @param[in] x  X-coordinate
-     * @param[in] y  Y-coordinate
-     */
-    Node(const unsigned int id, const double x, const double y);
+    double x;                 ///< X-coordinate of this node
+    double y;                 ///< Y-coordinate of this node
 };
 
 #endif  // NODE_H_
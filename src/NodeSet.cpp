@@ -0,0 +1,127 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+
+#include "NodeSet.h"
+
+using costFunction::Coordinates;
+
+NodeSet::NodeSet(const unsigned int first_id):
+    next_id(first_id) {
+}
+
+
+NodeSet::NodeSet(const vector<Node> &nodes):
+    next_id(1) {
+    reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        add(nodes[i]);
+    }
+}
+
+
+unsigned int
+NodeSet::add(const double x, const double y) {
+    const unsigned int identifier = next_id++;
+
+    id.push_back(identifier);
+    this->x.push_back(x);
+    this->y.push_back(y);
+
+    return identifier;
+}
+
+
+void
+NodeSet::add(const Node &node) {
+    id.push_back(node.getId());
+    x.push_back(node.getX());
+    y.push_back(node.getY());
+
+    if (node.getId() >= next_id) {
+        next_id = node.getId() + 1;
+    }
+}
+
+
+void
+NodeSet::reserve(const size_t size) {
+    id.reserve(size);
+    x.reserve(size);
+    y.reserve(size);
+}
+
+
+size_t
+NodeSet::getSize() const {
+    return id.size();
+}
+
+
+Node
+NodeSet::getNode(const size_t i) const {
+    return Node(id[i], x[i], y[i]);
+}
+
+
+void
+NodeSet::move(const size_t i, const double x, const double y) {
+    this->x[i] = x;
+    this->y[i] = y;
+}
+
+
+const unsigned int *
+NodeSet::getIds() const {
+    return id.empty() ? NULL : &id[0];
+}
+
+
+double *
+NodeSet::getX() {
+    return x.empty() ? NULL : &x[0];
+}
+
+
+double *
+NodeSet::getY() {
+    return y.empty() ? NULL : &y[0];
+}
+
+
+Coordinates
+NodeSet::getCoordinates() const {
+    Coordinates coordinates;
+
+    coordinates.id   = getIds();
+    coordinates.x    = x.empty() ? NULL : &x[0];
+    coordinates.y    = y.empty() ? NULL : &y[0];
+    coordinates.size = id.size();
+    return coordinates;
+}
+
+
+vector<Node>
+NodeSet::getNodesAsVector() const {
+    vector<Node> nodes;
+
+    nodes.reserve(id.size());
+    for (size_t i = 0; i < id.size(); i++) {
+        nodes.push_back(Node(id[i], x[i], y[i]));
+    }
+
+    return nodes;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef NODESET_H_
+#define NODESET_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "Node.h"
+#include "costFunction/CostFunction.h"
+
+using std::vector;
+
+/**
+ * A set of nodes, stored as a structure of arrays.
+ * Identifiers and coordinates are kept in separate contiguous arrays, so
+ * that loops over many nodes (cost kernels, perturbations) read only the
+ * data they need and can be vectorized.
+ * Identifiers are allocated by the set itself, from a given first one:
+ * no global state is involved, so that different threads can fill
+ * different sets at the same time. Threads may also read a set, or move
+ * different nodes of it, concurrently, as long as it is not resized.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class NodeSet {
+ public:
+    /**
+     * Constructor.
+     * Builds an empty set.
+     * @param[in] first_id Identifier of the first node added by add(x, y)
+     */
+    explicit NodeSet(const unsigned int first_id = 1);
+
+
+    /**
+     * Constructor.
+     * Copies a list of nodes, with their identifiers.
+     * @param[in] nodes Nodes to copy
+     */
+    explicit NodeSet(const vector<Node> &nodes);
+
+
+    /**
+     * Adds a node, allocating its identifier.
+     * Identifier is the lowest one above every identifier in the set, or
+     * the first identifier if the set is empty.
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     * @return Identifier of the new node
+     */
+    unsigned int add(const double x, const double y);
+
+
+    /**
+     * Adds a node, keeping its identifier.
+     * @param[in] node Node to add
+     */
+    void add(const Node &node);
+
+
+    /**
+     * Reserves space for a number of nodes.
+     * @param[in] size Number of nodes
+     */
+    void reserve(const size_t size);
+
+
+    /**
+     * Returns number of nodes in the set.
+     * @return Number of nodes
+     */
+    size_t getSize() const;
+
+    /**
+     * Returns a node.
+     * @param[in] i Position of the node
+     * @return Node at given position
+     */
+    Node getNode(const size_t i) const;
+
+    /**
+     * Moves a node.
+     * @param[in] i Position of the node
+     * @param[in] x New X-coordinate
+     * @param[in] y New Y-coordinate
+     */
+    void move(const size_t i, const double x, const double y);
+
+
+    /**
+     * Returns identifiers of the nodes.
+     * @return Identifiers, by position, or NULL if the set is empty
+     */
+    const unsigned int *getIds() const;
+
+    /**
+     * Returns X-coordinates of the nodes.
+     * @return X-coordinates, by position, or NULL if the set is empty
+     */
+    double *getX();
+
+    /**
+     * Returns Y-coordinates of the nodes.
+     * @return Y-coordinates, by position, or NULL if the set is empty
+     */
+    double *getY();
+
+    /**
+     * Returns the set as arrays for cost functions.
+     * Arrays are valid until the set is resized.
+     * @return Identifiers and coordinates of the nodes
+     */
+    costFunction::Coordinates getCoordinates() const;
+
+
+    /**
+     * Returns the list of nodes as a vector.
+     * @return Nodes as a vector, by position
+     */
+    vector<Node> getNodesAsVector() const;
+
+
+ private:
+    vector<unsigned int> id;  ///< Identifiers of the nodes
+    vector<double> x;         ///< X-coordinates of the nodes
+    vector<double> y;         ///< Y-coordinates of the nodes
+    unsigned int next_id;     ///< Identifier of next node added by add(x, y)
+};
+
+#endif  // NODESET_H_
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdint.h>
+
+#include "Parallel.h"
+
+/** State shared among threads running a list of tasks. */
+struct job_s {
+    Parallel::Task task;  ///< Function running a single task
+    void *argument;       ///< Argument passed to every task
+    size_t tasks;         ///< Number of tasks
+    size_t next;          ///< Next task to run
+};
+
+/** Type of the state shared among threads. */
+typedef struct job_s Job;
+
+
+/** Environment variable holding the default number of threads. */
+static const char THREADS_VARIABLE[] = "MEMOC_THREADS";
+
+
+/** Whether the calling thread is running a task. */
+static __thread bool in_task = false;
+
+
+/** Held by the thread running a list of tasks on the pool. */
+static pthread_mutex_t run_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** Protects the state of the pool below. */
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** Signalled when a list of tasks is published. */
+static pthread_cond_t published = PTHREAD_COND_INITIALIZER;
+
+/** Signalled when the last helper leaves a list of tasks. */
+static pthread_cond_t finished = PTHREAD_COND_INITIALIZER;
+
+/** Threads of the pool. */
+static size_t workers = 0;
+
+/** List of tasks being run, if any. */
+static Job *current = NULL;
+
+/** Number of the list of tasks being run, increased by every run. */
+static uint64_t generation = 0;
+
+/** Threads of the pool still allowed to join current list. */
+static size_t seats = 0;
+
+/** Threads of the pool still working on current list. */
+static size_t active = 0;
+
+
+/**
+ * Runs tasks of a list until none is left.
+ * @param[in, out] job List of tasks
+ */
+static void work(Job *job) {
+    size_t i;
+
+    while ((i = __sync_fetch_and_add(&job->next, 1)) < job->tasks) {
+        job->task(i, job->argument);
+    }
+}
+
+
+/**
+ * Body of a thread of the pool.
+ * Threads wait for lists of tasks and live as long as the process. Each
+ * list admits a given number of threads, the first ones to wake up.
+ * @param[in] argument Unused
+ * @return Never returns
+ */
+static void *pool_worker(void *argument) {
+    uint64_t seen = 0;
+
+    (void) argument;
+    in_task = true;
+    pthread_mutex_lock(&pool_mutex);
+    while (true) {
+        while (generation == seen) {
+            pthread_cond_wait(&published, &pool_mutex);
+        }
+        seen = generation;
+        if (seats == 0) {
+            continue;
+        }
+        seats--;
+
+        Job *job = current;
+        pthread_mutex_unlock(&pool_mutex);
+        work(job);
+        pthread_mutex_lock(&pool_mutex);
+
+        if (--active == 0) {
+            pthread_cond_signal(&finished);
+        }
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Grows the pool up to a number of threads.
+ * Must be called holding run_mutex.
+ * @param[in] size Wanted number of threads
+ * @return Number of threads in the pool, which may be lower than wanted
+ *         if threads cannot be created
+ */
+static size_t grow_pool(const size_t size) {
+    while (workers < size) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, pool_worker, NULL) != 0) {
+            break;
+        }
+        pthread_detach(thread);
+        workers++;
+    }
+
+    return workers;
+}
+
+
+
+unsigned int Parallel::threads = 0;
+
+
+/**
+ * Number of threads given by the environment, if any, comes before the
+ * number of online processors.
+ */
+unsigned int
+Parallel::getThreads() {
+    if (threads > 0) {
+        return threads;
+    }
+
+    const char *variable = getenv(THREADS_VARIABLE);
+    const long requested = (variable != NULL) ? atol(variable) : 0;
+    if (requested > 0) {
+        return requested;
+    }
+
+    const int64_t online = sysconf(_SC_NPROCESSORS_ONLN);
+    return (online > 0) ? online : 1;
+}
+
+
+void
+Parallel::setThreads(const unsigned int threads) {
+    Parallel::threads = threads;
+}
+
+
+/**
+ * Helpers come from a pool of threads which is created on first need and
+ * grown when more threads are requested, so that lists of tasks do not
+ * pay for creating threads. One list at a time runs on the pool: lists
+ * run by other threads meanwhile are run serially.
+ */
+void
+Parallel::run(const size_t tasks, Task task, void *argument) {
+    if (tasks == 0) {
+        return;
+    }
+
+    const size_t wanted = in_task ? 0
+                        : (getThreads() < tasks) ? getThreads() - 1
+                                                 : tasks - 1;
+    Job job;
+
+    job.task     = task;
+    job.argument = argument;
+    job.tasks    = tasks;
+    job.next     = 0;
+
+    if (wanted == 0 || pthread_mutex_trylock(&run_mutex) != 0) {
+        work(&job);
+        return;
+    }
+
+    // Publishes the list to the pool, which may hold more threads
+    const size_t pool    = grow_pool(wanted),
+                 helpers = (pool < wanted) ? pool : wanted;
+    pthread_mutex_lock(&pool_mutex);
+    current = &job;
+    seats   = helpers;
+    active  = helpers;
+    generation++;
+    pthread_cond_broadcast(&published);
+    pthread_mutex_unlock(&pool_mutex);
+
+    // Tasks of the calling thread run nested lists serially
+    in_task = true;
+    work(&job);
+    in_task = false;
+
+    // Waits for helpers to leave the list
+    pthread_mutex_lock(&pool_mutex);
+    while (active > 0) {
+        pthread_cond_wait(&finished, &pool_mutex);
+    }
+    current = NULL;
+    pthread_mutex_unlock(&pool_mutex);
+    pthread_mutex_unlock(&run_mutex);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <cstddef>
+
+/**
+ * Runs independent tasks on a set of threads.
+ * Tasks are numbered from 0 and are assigned dynamically to threads, so
+ * that callers only have to split their work into enough tasks to keep
+ * every thread busy. The calling thread takes part in the work and
+ * returns only when every task is over (fork/join); other threads come
+ * from a pool which lives as long as the process.
+ * Tasks may run tasks in turn: nested lists are run serially by the
+ * thread running the outer task, so that processors are never
+ * oversubscribed.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class Parallel {
+ public:
+    /**
+     * A task.
+     * @param[in] task     Index of the task to run
+     * @param[in] argument Argument shared by every task
+     */
+    typedef void (*Task)(const size_t task, void *argument);
+
+
+    /**
+     * Returns number of threads used to run tasks.
+     * Defaults to the value of the MEMOC_THREADS environment variable,
+     * if set to a positive number, or to the number of online processors.
+     * @return Number of threads
+     */
+    static unsigned int getThreads();
+
+    /**
+     * Sets number of threads used to run tasks.
+     * @param[in] threads Number of threads (0 restores the default)
+     */
+    static void setThreads(const unsigned int threads);
+
+
+    /**
+     * Runs a list of tasks.
+     * @param[in] tasks    Number of tasks to run
+     * @param[in] task     Function running a single task
+     * @param[in] argument Argument passed to every task
+     */
+    static void run(const size_t tasks, Task task, void *argument);
+
+
+ private:
+    static unsigned int threads;  ///< Number of threads, 0 for default
+};
+
+#endif  // PARALLEL_H_
@@ -0,0 +1,311 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdlib.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "Parser.h"
+#include "Parallel.h"
+
+using std::vector;
+
+/** Powers of ten which are exactly representable as doubles. */
+static const double POWERS_OF_TEN[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/** Largest mantissa which is exactly representable as a double. */
+static const uint64_t MAX_EXACT_MANTISSA = static_cast<uint64_t>(1) << 53;
+
+/** Buffers smaller than this are parsed by a single thread. */
+static const size_t PARALLEL_THRESHOLD = 1 << 20;
+
+/** Number of blocks each thread parses, for load balancing. */
+static const size_t BLOCKS_PER_THREAD = 8;
+
+
+/**
+ * Tells whether a character is a whitespace.
+ * @param[in] c Character to test
+ * @return True iff c is a whitespace
+ */
+static inline bool is_space(const char c) {
+    return c == ' ' || c == '\n' || c == '\t' ||
+           c == '\r' || c == '\v' || c == '\f';
+}
+
+
+/**
+ * Tells whether a character is a decimal digit.
+ * @param[in] c Character to test
+ * @return True iff c is a digit
+ */
+static inline bool is_digit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+
+
+/** Work shared by threads parsing a buffer. */
+struct parse_job_s {
+    vector<const char *> bounds;  ///< Bounds of the blocks
+    vector<size_t> counts;        ///< Numbers in each block
+    vector<size_t> firsts;        ///< Index of first number in each block
+    vector<size_t> parsed;        ///< Numbers parsed in each block
+    double *values;               ///< Parsed numbers
+    size_t count;                 ///< Number of numbers to parse
+};
+
+/** Type of the work shared by threads parsing a buffer. */
+typedef struct parse_job_s ParseJob;
+
+
+/**
+ * Counts numbers in a block.
+ * @param[in]      block    Index of the block
+ * @param[in, out] argument Pointer to the shared job
+ */
+static void count_task(const size_t block, void *argument) {
+    ParseJob *job = reinterpret_cast<ParseJob *>(argument);
+    const char *c = job->bounds[block], *end = job->bounds[block + 1];
+    size_t count = 0;
+    bool in_token = false;
+
+    for (; c < end; c++) {
+        const bool space = is_space(*c);
+        count += !space && !in_token;
+        in_token = !space;
+    }
+
+    job->counts[block] = count;
+}
+
+
+/**
+ * Parses numbers in a block.
+ * Index of the first number in the block must be known.
+ * @param[in]      block    Index of the block
+ * @param[in, out] argument Pointer to the shared job
+ */
+static void parse_task(const size_t block, void *argument) {
+    ParseJob *job = reinterpret_cast<ParseJob *>(argument);
+    Parser parser(job->bounds[block], job->bounds[block + 1]);
+    const size_t first = job->firsts[block];
+    size_t i = first;
+    double value;
+
+    while (i < job->count && parser.parse(&value)) {
+        job->values[i++] = value;
+    }
+
+    job->parsed[block] = i - first;
+}
+
+
+
+Parser::Parser(const char *begin, const char *end):
+    cursor(begin), end(end) {
+}
+
+
+bool
+Parser::parse(uint64_t *value) {
+    uint64_t result = 0;
+
+    if (!skip()) {
+        return false;
+    }
+
+    const char *c = cursor;
+    if (*c == '+') {
+        c++;
+    }
+    if (c == end || !is_digit(*c)) {
+        return false;
+    }
+
+    for (; c < end && is_digit(*c); c++) {
+        result = result * 10 + (*c - '0');
+    }
+
+    cursor = c;
+    *value = result;
+    return true;
+}
+
+
+/**
+ * Follows Clinger's fast path: when both the decimal mantissa and the
+ * power of ten are exact doubles, their product (or quotient) is rounded
+ * only once, hence correctly.
+ */
+bool
+Parser::parse(double *value) {
+    uint64_t mantissa = 0;
+    int exponent = 0, digits = 0;
+    bool negative = false, exact = true, any = false;
+
+    if (!skip()) {
+        return false;
+    }
+
+    const char *c = cursor;
+    if (*c == '-' || *c == '+') {
+        negative = (*c == '-');
+        c++;
+    }
+
+    // Integer part
+    for (; c < end && is_digit(*c); c++) {
+        any = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*c - '0');
+            digits += (mantissa > 0);
+        } else {
+            exact = false;
+        }
+    }
+
+    // Fractional part
+    if (c < end && *c == '.') {
+        for (c++; c < end && is_digit(*c); c++) {
+            any = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*c - '0');
+                digits += (mantissa > 0);
+                exponent--;
+            } else {
+                exact = false;
+            }
+        }
+    }
+
+    // Exponent
+    if (any && c < end && (*c == 'e' || *c == 'E')) {
+        const char *e = c + 1;
+        bool negative_exponent = false;
+        int power = 0;
+
+        if (e < end && (*e == '-' || *e == '+')) {
+            negative_exponent = (*e == '-');
+            e++;
+        }
+        if (e < end && is_digit(*e)) {
+            for (; e < end && is_digit(*e); e++) {
+                power = (power < 10000) ? power * 10 + (*e - '0') : power;
+            }
+            exponent += negative_exponent ? -power : power;
+            c = e;
+        }
+    }
+
+    if (any && exact && (c == end || is_space(*c)) &&
+        mantissa <= MAX_EXACT_MANTISSA && exponent >= -22 && exponent <= 22) {
+        double result = static_cast<double>(mantissa);
+        if (exponent < 0) {
+            result /= POWERS_OF_TEN[-exponent];
+        } else {
+            result *= POWERS_OF_TEN[exponent];
+        }
+        *value  = negative ? -result : result;
+        cursor = c;
+        return true;
+    }
+
+    // Slow path
+    char *stop;
+    const double result = strtod(cursor, &stop);
+    if (stop == cursor) {
+        return false;
+    }
+
+    *value = result;
+    cursor = (stop < end) ? stop : end;
+    return true;
+}
+
+
+const char *
+Parser::getPosition() const {
+    return cursor;
+}
+
+
+size_t
+Parser::parseAll(
+    const char *begin,
+    const char *end,
+    double *values,
+    const size_t count) {
+    const size_t length = end - begin,
+                 blocks = (length < PARALLEL_THRESHOLD)
+                        ? 1
+                        : Parallel::getThreads() * BLOCKS_PER_THREAD;
+    ParseJob job;
+
+    // Splits buffer into blocks, moving bounds to the next whitespace
+    job.bounds.push_back(begin);
+    for (size_t i = 1; i < blocks; i++) {
+        const char *bound = begin + length / blocks * i;
+        if (bound < job.bounds.back()) {
+            bound = job.bounds.back();
+        }
+        while (bound < end && !is_space(*bound)) {
+            bound++;
+        }
+        job.bounds.push_back(bound);
+    }
+    job.bounds.push_back(end);
+    job.counts.resize(blocks);
+    job.firsts.resize(blocks);
+    job.parsed.resize(blocks);
+    job.values = values;
+    job.count  = count;
+
+    // Counts numbers in each block, then finds where each block begins
+    Parallel::run(blocks, count_task, &job);
+    size_t first = 0;
+    for (size_t i = 0; i < blocks; i++) {
+        job.firsts[i] = first;
+        first += job.counts[i];
+    }
+
+    // Parses blocks, then counts numbers parsed before the first failure
+    Parallel::run(blocks, parse_task, &job);
+    size_t parsed = 0;
+    for (size_t i = 0; i < blocks && job.firsts[i] < count; i++) {
+        const size_t left     = count - job.firsts[i],
+                     expected = (job.counts[i] < left) ? job.counts[i] : left;
+        parsed += job.parsed[i];
+        if (job.parsed[i] < expected) {
+            break;
+        }
+    }
+
+    return parsed;
+}
+
+
+bool
+Parser::skip() {
+    while (cursor < end && is_space(*cursor)) {
+        cursor++;
+    }
+
+    return cursor < end;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PARSER_H_
+#define PARSER_H_
+
+#include <stdint.h>
+
+#include <cstddef>
+
+/**
+ * Parses numbers out of a text buffer.
+ * Numbers are separated by whitespaces, as in the text format of
+ * instances. Parsing does not depend on streams nor on locales: numbers
+ * which can be converted exactly with a single rounding are converted
+ * in place, the others are delegated to strtod, so that results are
+ * identical to those of formatted stream extraction.
+ * Buffers must be terminated by a null character.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class Parser {
+ public:
+    /**
+     * Constructor.
+     * @param[in] begin Beginning of the buffer
+     * @param[in] end   End of the buffer
+     */
+    Parser(const char *begin, const char *end);
+
+
+    /**
+     * Parses next number as an unsigned integer.
+     * @param[out] value Parsed number
+     * @return True iff a number was parsed
+     */
+    bool parse(uint64_t *value);
+
+    /**
+     * Parses next number as a double.
+     * @param[out] value Parsed number
+     * @return True iff a number was parsed
+     */
+    bool parse(double *value);
+
+
+    /**
+     * Returns current position in the buffer.
+     * @return Position of the first character not parsed yet
+     */
+    const char *getPosition() const;
+
+
+    /**
+     * Parses a sequence of doubles.
+     * Large buffers are split into blocks at whitespaces, blocks are
+     * parsed in parallel.
+     * @param[in]  begin  Beginning of the buffer
+     * @param[in]  end    End of the buffer
+     * @param[out] values Parsed numbers
+     * @param[in]  count  Number of numbers to parse
+     * @return Number of numbers actually parsed
+     */
+    static size_t parseAll(
+        const char *begin,
+        const char *end,
+        double *values,
+        const size_t count);
+
+
+ private:
+    const char *cursor;  ///< Current position
+    const char *end;     ///< End of the buffer
+
+
+    /**
+     * Skips whitespaces.
+     * @return True iff there are characters left
+     */
+    bool skip();
+};
+
+#endif  // PARSER_H_
@@ -17,39 +17,350 @@
 #include <unistd.h>
 #include <time.h>
 #include <math.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <cfloat>
 
 #include "RNG.h"
 
+/** Polynomial jumping ahead by 2^128 numbers. */
+static const uint64_t JUMP[] = {
+    0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+    0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+};
+
+/** Polynomial jumping ahead by 2^192 numbers. */
+static const uint64_t LONG_JUMP[] = {
+    0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL,
+    0x77710069854EE241ULL, 0x39109BB02ACBE635ULL
+};
+
+/** Number of layers of the ziggurat. */
+static const unsigned int LAYERS = 128;
+
+/** Start of the tail of the ziggurat. */
+static const double TAIL = 3.442619855899;
+
+/** Area of every layer of the ziggurat. */
+static const double AREA = 9.91256303526217e-3;
+
+/** Right edges of the layers of the ziggurat. */
+static double edge[LAYERS + 1];
+
+/** Ratios between edges of consecutive layers. */
+static double ratio[LAYERS];
+
+/** Builds the tables of the ziggurat only once. */
+static pthread_once_t ziggurat_once = PTHREAD_ONCE_INIT;
+
+/** Master state, from which threads take their sequences. */
+static uint64_t master[4];
+
+/** Whether master state was seeded. */
+static bool master_seeded = false;
+
+/** Protects master state. */
+static pthread_mutex_t master_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** Sequence of streams of this thread. */
+static __thread uint64_t sequence[4];
+
+/** Whether this thread took its sequence. */
+static __thread bool seeded = false;
+
+/** Key of the generators of the threads. */
+static pthread_key_t local_key;
+
+/** Creates the key of the generators of the threads only once. */
+static pthread_once_t local_once = PTHREAD_ONCE_INIT;
+
+
+/**
+ * Returns next number of a SplitMix64 sequence.
+ * Used to expand a seed into a whole state: close seeds give unrelated
+ * states.
+ * @param[in,out] x State of the sequence
+ * @return Next number
+ */
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+
+/**
+ * Fills a state from a seed.
+ * @param[out] s    State to fill
+ * @param[in]  seed Seed
+ */
+static void seed_state(uint64_t *s, uint64_t seed) {
+    for (unsigned int i = 0; i < 4; i++) {
+        s[i] = splitmix64(&seed);
+    }
+}
+
+
+/**
+ * Rotates bits of an integer to the left.
+ * @param[in] x Integer to rotate
+ * @param[in] k Number of bits
+ * @return Rotated integer
+ */
+static inline uint64_t rotl(const uint64_t x, const int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+
+/**
+ * Advances a state of xoshiro256**.
+ * @param[in,out] s State to advance
+ * @return Number generated
+ */
+static inline uint64_t advance(uint64_t *s) {
+    const uint64_t result = rotl(s[1] * 5, 7) * 9,
+                   t      = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3]  = rotl(s[3], 45);
+
+    return result;
+}
+
+
+/**
+ * Jumps a state of xoshiro256** ahead.
+ * @param[in,out] s          State to jump
+ * @param[in]     polynomial Jump polynomial
+ */
+static void jump_state(uint64_t *s, const uint64_t *polynomial) {
+    uint64_t t[4] = {0, 0, 0, 0};
+
+    for (unsigned int i = 0; i < 4; i++) {
+        for (unsigned int b = 0; b < 64; b++) {
+            if (polynomial[i] & (1ULL << b)) {
+                t[0] ^= s[0];
+                t[1] ^= s[1];
+                t[2] ^= s[2];
+                t[3] ^= s[3];
+            }
+            advance(s);
+        }
+    }
+    memcpy(s, t, sizeof(t));
+}
+
+
+/**
+ * Gives the calling thread its sequence of streams.
+ * Sequence is taken from master state, which is then jumped ahead.
+ */
+static void take_sequence() {
+    pthread_mutex_lock(&master_mutex);
+    if (!master_seeded) {
+        seed_state(master, (static_cast<uint64_t>(time(NULL)) << 32)
+                           ^ static_cast<uint64_t>(getpid()));
+        master_seeded = true;
+    }
+    memcpy(sequence, master, sizeof(master));
+    jump_state(master, LONG_JUMP);
+    pthread_mutex_unlock(&master_mutex);
+    seeded = true;
+}
+
+
+/**
+ * Builds the tables of the ziggurat.
+ * Layers are rectangles of the same area covering the density of the
+ * standard normal distribution; the bottom one includes the tail.
+ */
+static void build_ziggurat() {
+    double f = exp(-0.5 * TAIL * TAIL);
+
+    edge[0]      = AREA / f;
+    edge[1]      = TAIL;
+    edge[LAYERS] = 0.0;
+    for (unsigned int i = 2; i < LAYERS; i++) {
+        edge[i] = sqrt(-2.0 * log(AREA / edge[i - 1] + f));
+        f       = exp(-0.5 * edge[i] * edge[i]);
+    }
+    for (unsigned int i = 0; i < LAYERS; i++) {
+        ratio[i] = edge[i + 1] / edge[i];
+    }
+}
+
+
+/**
+ * Destroys the generator of a thread.
+ * @param[in] rng Generator
+ */
+static void destroy_local(void *rng) {
+    delete reinterpret_cast<RNG *>(rng);
+}
+
+
+/**
+ * Creates the key of the generators of the threads.
+ */
+static void create_key() {
+    pthread_key_create(&local_key, destroy_local);
+}
+
+
+/**
+ * Destroys the generator of the calling thread, if any.
+ */
+static void drop_local() {
+    pthread_once(&local_once, create_key);
+    destroy_local(pthread_getspecific(local_key));
+    pthread_setspecific(local_key, NULL);
+}
+
+
 RNG::RNG() {
-    seed = time(NULL) + getpid();
+    pthread_once(&ziggurat_once, build_ziggurat);
+    if (!seeded) {
+        take_sequence();
+    }
+    memcpy(state, sequence, sizeof(state));
+    jump_state(sequence, JUMP);
 }
 
 
 
-RNG::RNG(const unsigned int seed) {
-    this->seed = seed;
+RNG::RNG(const uint64_t seed) {
+    pthread_once(&ziggurat_once, build_ziggurat);
+    seed_state(state, seed);
+}
+
+
+void
+RNG::setSeed(const uint64_t seed) {
+    seed_state(sequence, seed);
+    seeded = true;
+    drop_local();
+}
+
+
+void
+RNG::setMasterSeed(const uint64_t seed) {
+    pthread_mutex_lock(&master_mutex);
+    seed_state(master, seed);
+    master_seeded = true;
+    pthread_mutex_unlock(&master_mutex);
+
+    seeded = false;
+    drop_local();
+}
+
+
+RNG &
+RNG::local() {
+    pthread_once(&local_once, create_key);
+    RNG *rng = reinterpret_cast<RNG *>(pthread_getspecific(local_key));
+
+    if (rng == NULL) {
+        rng = new RNG();
+        pthread_setspecific(local_key, rng);
+    }
+
+    return *rng;
+}
+
+
+void
+RNG::jump() {
+    jump_state(state, JUMP);
+}
+
+
+uint64_t
+RNG::next() {
+    return advance(state);
 }
 
 
 double
 RNG::uniform(const double min, const double max) {
-    const double base  = static_cast<double>(rand_r(&seed)) / RAND_MAX,
+    const double base  = (next() >> 11) * (1.0 / 9007199254740992.0),
                  delta = max - min;
     return min + base * delta;
 }
 
 
+void
+RNG::uniform(
+    double *values,
+    const size_t size,
+    const double min,
+    const double max) {
+    const double delta = max - min;
+
+    for (size_t i = 0; i < size; i++) {
+        values[i] = min
+                  + (advance(state) >> 11) * (1.0 / 9007199254740992.0) * delta;
+    }
+}
+
+
 double
 RNG::normal(const double mi, const double sigma) {
-    double U1, U2, W, X;
+    return mi + sigma * gaussian();
+}
+
+
+void
+RNG::normal(
+    double *values,
+    const size_t size,
+    const double mi,
+    const double sigma) {
+    for (size_t i = 0; i < size; i++) {
+        values[i] = gaussian();
+    }
+    for (size_t i = 0; i < size; i++) {
+        values[i] = mi + sigma * values[i];
+    }
+}
+
+
+/**
+ * Lowest 7 bits of a random integer choose the layer, highest 53 bits a
+ * point on it. Points inside the next layer up are accepted at once;
+ * the others fall on the tail or on the border of the density, and are
+ * accepted or rejected exactly.
+ */
+double
+RNG::gaussian() {
+    for (;;) {
+        const uint64_t r = advance(state);
+        const unsigned int i = r & (LAYERS - 1);
+        const double u = 2.0 * ((r >> 11) * (1.0 / 9007199254740992.0)) - 1.0;
 
-    do {
-        U1 = -1 + (static_cast<double>(rand_r(&seed)) / RAND_MAX) * 2;
-        U2 = -1 + (static_cast<double>(rand_r(&seed)) / RAND_MAX) * 2;
-        W  = pow(U1, 2) + pow(U2, 2);
-    } while (W >= 1 || W == 0);
+        if (fabs(u) < ratio[i]) {
+            return u * edge[i];
+        }
 
-    X = U1 * sqrt((-2.0 * log(W)) / W);
+        if (i == 0) {
+            double x, y;
+            do {
+                x = log(uniform(0.0, 1.0) + DBL_MIN) / TAIL;
+                y = log(uniform(0.0, 1.0) + DBL_MIN);
+            } while (-2.0 * y < x * x);
+            return (u < 0.0) ? x - TAIL : TAIL - x;
+        }
 
-    return mi + sigma * X;
+        const double x  = u * edge[i],
+                     f0 = exp(-0.5 * (edge[i] * edge[i] - x * x)),
+                     f1 = exp(-0.5 * (edge[i + 1] * edge[i + 1] - x * x));
+        if (f1 + uniform(0.0, 1.0) * (f0 - f1) < 1.0) {
+            return x;
+        }
+    }
 }
@@ -16,8 +16,20 @@
 #ifndef RNG_H_
 #define RNG_H_
 
+#include <stdint.h>
+
+#include <cstddef>
+
 /**
  * A random number generator.
+ * Numbers come from xoshiro256**, a generator with a period of 2^256 - 1
+ * whose sequence can be jumped ahead, so that many non-overlapping
+ * streams can be drawn from a single seed.
+ * Streams are organized in two levels: every thread takes its own
+ * sequence of streams from a process-wide master seed, and every
+ * generator built by the default constructor takes the next stream of the
+ * sequence of its thread. A generator must not be shared among threads:
+ * use local() to get the generator of the calling thread.
  *
  * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
  */
@@ -25,6 +37,8 @@ class RNG {
  public:
     /**
      * Constructor.
+     * Takes the next stream of the sequence of the calling thread. Unless
+     * a seed was set, streams depend on time and process.
      */
     RNG();
 
@@ -33,12 +47,58 @@ class RNG {
      * Constructor.
      * @param[in] seed Seed used to generate random numbers
      */
-    explicit RNG(const unsigned int seed);
+    explicit RNG(const uint64_t seed);
+
+
+    /**
+     * Seeds generators built by the default constructor.
+     * Affects the calling thread only: generators it builds afterwards
+     * with the default constructor take successive streams of a sequence
+     * starting from given seed, so that their numbers are reproducible.
+     * @param[in] seed Seed of the sequence
+     */
+    static void setSeed(const uint64_t seed);
+
+
+    /**
+     * Seeds the whole process.
+     * Threads which did not set their own seed take successive sequences
+     * of streams from given seed, in the order they first need one. The
+     * calling thread restarts from the first sequence.
+     * @param[in] seed Master seed
+     */
+    static void setMasterSeed(const uint64_t seed);
+
+
+    /**
+     * Returns the generator of the calling thread.
+     * Generator is built by the default constructor when a thread first
+     * needs it, and rebuilt after every change of seed of that thread.
+     * @return Generator of the calling thread
+     */
+    static RNG &local();
+
+
+    /**
+     * Jumps ahead.
+     * Advances the generator by 2^128 numbers, as if as many numbers were
+     * drawn.
+     */
+    void jump();
+
+
+    /**
+     * Returns a random integer.
+     * Every bit is uniformly distributed.
+     * @return Random 64 bits integer
+     */
+    uint64_t next();
 
 
     /**
      * Returns a random number in given interval.
-     * Returns a random number from an uniform distribution.
+     * Returns a random number from an uniform distribution over
+     * [min, max).
      * @param[in] min Lowerbound
      * @param[in] max Upperbound
      * @return Random number
@@ -46,9 +106,27 @@ class RNG {
     double uniform(const double min, const double max);
 
 
+    /**
+     * Fills an array with random numbers in given interval.
+     * Numbers are the same that as many calls to uniform(min, max)
+     * would return.
+     * @param[out] values Array to fill
+     * @param[in]  size   Number of values
+     * @param[in]  min    Lowerbound
+     * @param[in]  max    Upperbound
+     */
+    void uniform(
+        double *values,
+        const size_t size,
+        const double min,
+        const double max);
+
+
     /**
      * Returns a random number.
-     * Returns a random number from a normal distribution.
+     * Returns a random number from a normal distribution, sampled with
+     * the ziggurat method: most numbers cost a single random integer, a
+     * table lookup and a comparison.
      * @param[in] mi    Mean of the distribution
      * @param[in] sigma Variance of the distribution
      * @return Random number from a normal distribution
@@ -56,8 +134,31 @@ class RNG {
     double normal(const double mi, const double sigma);
 
 
+    /**
+     * Fills an array with random numbers from a normal distribution.
+     * Numbers are the same that as many calls to normal(mi, sigma) would
+     * return; scaling is applied to the whole array at once.
+     * @param[out] values Array to fill
+     * @param[in]  size   Number of values
+     * @param[in]  mi     Mean of the distribution
+     * @param[in]  sigma  Variance of the distribution
+     */
+    void normal(
+        double *values,
+        const size_t size,
+        const double mi,
+        const double sigma);
+
+
  private:
-    unsigned int seed;
+    uint64_t state[4];  ///< State of the generator
+
+
+    /**
+     * Returns a random number from the standard normal distribution.
+     * @return Random number, with mean 0 and variance 1
+     */
+    double gaussian();
 };
 
 #endif  // RNG_H_
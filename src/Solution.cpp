@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "Solution.h"
+#include "Writer.h"
 
 Solution::Solution(const vector<Node> &nodes, const Instance &instance) :
     nodes(nodes), instance(instance), cost(computeCost(nodes, instance)) {
@@ -42,16 +43,18 @@ Solution::getNodesAsVector() const {
 
 Solution &
 Solution::save(ostream *stream) const {
+    Writer writer(stream);
+
     if (cost < 0.0) {
-        *stream << 0 << " " << cost << std::endl;
+        writer.write(static_cast<uint64_t>(0)).write(' ')
+              .write(cost).write('\n');
         return const_cast<Solution &>(*this);
     }
 
-    *stream << nodes.size() << " "
-            << cost
-            << std::endl;
+    writer.write(static_cast<uint64_t>(nodes.size())).write(' ')
+          .write(cost).write('\n');
     for (unsigned int i = 0; i < nodes.size(); i++) {
-        nodes[i].save(stream);
+        nodes[i].save(&writer);
     }
 
     return const_cast<Solution &>(*this);
@@ -0,0 +1,292 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <vector>
+
+#include "Writer.h"
+#include "Parallel.h"
+
+/** Powers of ten which are exactly representable as doubles. */
+static const double POWERS_OF_TEN[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/** Number of significant digits written by %g. */
+static const int PRECISION = 6;
+
+/** Rows formatted by a single task when writing a matrix. */
+static const size_t ROWS_PER_TASK = 16;
+
+/** Tasks formatted before their output is written, per thread. */
+static const size_t TASKS_PER_THREAD = 4;
+
+
+/**
+ * Writes the decimal representation of an unsigned integer.
+ * @param[out] buffer Buffer of at least 20 characters
+ * @param[in]  value  Number to write
+ * @return Number of characters written
+ */
+static size_t format_unsigned(char *buffer, uint64_t value) {
+    char digits[20];
+    size_t n = 0;
+
+    do {
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    for (size_t i = 0; i < n; i++) {
+        buffer[i] = digits[n - 1 - i];
+    }
+
+    return n;
+}
+
+
+
+/** Work shared by threads formatting a matrix. */
+struct format_job_s {
+    const double *values;           ///< Matrix, row major
+    size_t rows;                    ///< Number of rows
+    size_t cols;                    ///< Number of columns
+    size_t first;                   ///< First task of the current window
+    vector< vector<char> > output;  ///< Output of each task in the window
+};
+
+/** Type of the work shared by threads formatting a matrix. */
+typedef struct format_job_s FormatJob;
+
+
+/**
+ * Formats a group of rows of a matrix.
+ * @param[in]      task     Index of the task within the window
+ * @param[in, out] argument Pointer to the shared job
+ */
+static void format_task(const size_t task, void *argument) {
+    FormatJob *job = reinterpret_cast<FormatJob *>(argument);
+    vector<char> &output = job->output[task];
+    const size_t begin = (job->first + task) * ROWS_PER_TASK,
+                 end   = (begin + ROWS_PER_TASK < job->rows)
+                       ? begin + ROWS_PER_TASK
+                       : job->rows;
+    size_t length = 0;
+
+    output.resize((end - begin) * (job->cols * 32 + 1));
+    for (size_t i = begin; i < end; i++) {
+        const double *row = job->values + i * job->cols;
+        for (size_t j = 0; j < job->cols; j++) {
+            length += Writer::format(&output[length], row[j]);
+            output[length++] = ' ';
+        }
+        output[length++] = '\n';
+    }
+    output.resize(length);
+}
+
+
+
+Writer::Writer(ostream *stream, const size_t capacity):
+    stream(stream), buffer(capacity > 64 ? capacity : 64), length(0) {
+}
+
+
+Writer::~Writer() {
+    flush();
+}
+
+
+Writer &
+Writer::write(const char value) {
+    reserve(1);
+    buffer[length++] = value;
+
+    return *this;
+}
+
+
+Writer &
+Writer::write(const uint64_t value) {
+    reserve(20);
+    length += format_unsigned(&buffer[length], value);
+
+    return *this;
+}
+
+
+Writer &
+Writer::write(const double value) {
+    reserve(32);
+    length += format(&buffer[length], value);
+
+    return *this;
+}
+
+
+Writer &
+Writer::flush() {
+    if (length > 0) {
+        stream->write(&buffer[0], length);
+        length = 0;
+    }
+
+    return *this;
+}
+
+
+void
+Writer::writeMatrix(
+    ostream *stream,
+    const double *values,
+    const size_t rows,
+    const size_t cols) {
+    const size_t tasks  = (rows + ROWS_PER_TASK - 1) / ROWS_PER_TASK,
+                 window = Parallel::getThreads() * TASKS_PER_THREAD;
+    FormatJob job;
+
+    job.values = values;
+    job.rows   = rows;
+    job.cols   = cols;
+    job.output.resize(window);
+
+    // Formats a window of tasks in parallel, then writes it in order
+    for (job.first = 0; job.first < tasks; job.first += window) {
+        const size_t n = (job.first + window < tasks) ? window
+                                                      : tasks - job.first;
+        Parallel::run(n, format_task, &job);
+        for (size_t i = 0; i < n; i++) {
+            if (!job.output[i].empty()) {
+                stream->write(&job.output[i][0], job.output[i].size());
+            }
+        }
+    }
+}
+
+
+/**
+ * Values are scaled to six integer digits with a single, correctly
+ * rounded operation; the result is rounded to an integer unless it lies
+ * too close to a tie, in which case (and for very large or very small
+ * values) formatting is delegated to snprintf.
+ */
+size_t
+Writer::format(char *buffer, const double value) {
+    const double magnitude = fabs(value);
+    size_t n = 0;
+
+    if (value == 0.0) {
+        if (signbit(value)) {
+            buffer[n++] = '-';
+        }
+        buffer[n++] = '0';
+        return n;
+    }
+
+    if (!(magnitude >= 1e-5 && magnitude < 1e15)) {
+        return snprintf(buffer, 32, "%g", value);
+    }
+
+    // Scales to [10^5, 10^6) and rounds
+    int exponent = static_cast<int>(floor(log10(magnitude)));
+    double scaled = 0.0;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        const int shift = PRECISION - 1 - exponent;
+        scaled = (shift >= 0) ? magnitude * POWERS_OF_TEN[shift]
+                              : magnitude / POWERS_OF_TEN[-shift];
+        if (scaled < 1e5) {
+            exponent--;
+        } else if (scaled >= 1e6) {
+            exponent++;
+        } else {
+            break;
+        }
+    }
+    const double integral = floor(scaled),
+                 fraction = scaled - integral;
+    if (scaled < 1e5 || scaled >= 1e6 || fabs(fraction - 0.5) < 1e-6) {
+        return snprintf(buffer, 32, "%g", value);
+    }
+    uint64_t mantissa = static_cast<uint64_t>(integral) + (fraction > 0.5);
+    if (mantissa == 1000000) {
+        mantissa = 100000;
+        exponent++;
+    }
+
+    // Collects significant digits, without trailing zeros
+    char digits[PRECISION];
+    int count = PRECISION;
+    format_unsigned(digits, mantissa);
+    while (count > 1 && digits[count - 1] == '0') {
+        count--;
+    }
+
+    if (value < 0.0) {
+        buffer[n++] = '-';
+    }
+
+    if (exponent < -4 || exponent >= PRECISION) {
+        // Scientific notation
+        buffer[n++] = digits[0];
+        if (count > 1) {
+            buffer[n++] = '.';
+            for (int i = 1; i < count; i++) {
+                buffer[n++] = digits[i];
+            }
+        }
+        buffer[n++] = 'e';
+        buffer[n++] = (exponent < 0) ? '-' : '+';
+        const int e = (exponent < 0) ? -exponent : exponent;
+        if (e < 10) {
+            buffer[n++] = '0';
+        }
+        n += format_unsigned(buffer + n, e);
+    } else if (exponent >= 0) {
+        // Fixed notation, integer part is not zero
+        for (int i = 0; i <= exponent; i++) {
+            buffer[n++] = digits[i];
+        }
+        if (count > exponent + 1) {
+            buffer[n++] = '.';
+            for (int i = exponent + 1; i < count; i++) {
+                buffer[n++] = digits[i];
+            }
+        }
+    } else {
+        // Fixed notation, integer part is zero
+        buffer[n++] = '0';
+        buffer[n++] = '.';
+        for (int i = 0; i < -exponent - 1; i++) {
+            buffer[n++] = '0';
+        }
+        for (int i = 0; i < count; i++) {
+            buffer[n++] = digits[i];
+        }
+    }
+
+    return n;
+}
+
+
+void
+Writer::reserve(const size_t space) {
+    if (length + space > buffer.size()) {
+        flush();
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef WRITER_H_
+#define WRITER_H_
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <vector>
+#include <ostream>
+
+using std::vector;
+using std::ostream;
+
+/**
+ * Writes numbers to a stream through a large buffer.
+ * Output is byte-compatible with the default formatting of streams
+ * (doubles are written as by printf's %g), but numbers are formatted
+ * without streams nor locales and the stream is never flushed: buffer
+ * is handed to the stream when full and when the writer is destroyed.
+ *
+ * This class has a Fluent Interface.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class Writer {
+ public:
+    /**
+     * Constructor.
+     * @param[out] stream   Stream to write to
+     * @param[in]  capacity Size of the buffer
+     */
+    explicit Writer(ostream *stream, const size_t capacity = 1 << 20);
+
+
+    /**
+     * Destructor.
+     * Hands buffered data to the stream.
+     */
+    ~Writer();
+
+
+    /**
+     * Writes a character.
+     * @param[in] value Character to write
+     * @return This writer itself
+     */
+    Writer &write(const char value);
+
+    /**
+     * Writes an unsigned integer.
+     * @param[in] value Number to write
+     * @return This writer itself
+     */
+    Writer &write(const uint64_t value);
+
+    /**
+     * Writes a double.
+     * @param[in] value Number to write
+     * @return This writer itself
+     */
+    Writer &write(const double value);
+
+
+    /**
+     * Hands buffered data to the stream.
+     * Stream itself is not flushed.
+     * @return This writer itself
+     */
+    Writer &flush();
+
+
+    /**
+     * Writes a matrix of doubles, one row per line.
+     * Every number is followed by a space. Rows are formatted in
+     * parallel into separate buffers which are written in order.
+     * @param[out] stream Stream to write to
+     * @param[in]  values Matrix, row major
+     * @param[in]  rows   Number of rows
+     * @param[in]  cols   Number of columns
+     */
+    static void writeMatrix(
+        ostream *stream,
+        const double *values,
+        const size_t rows,
+        const size_t cols);
+
+
+    /**
+     * Formats a double as printf's %g would.
+     * @param[out] buffer Buffer of at least 32 characters
+     * @param[in]  value  Number to format
+     * @return Number of characters written
+     */
+    static size_t format(char *buffer, const double value);
+
+
+ private:
+    ostream *stream;      ///< Stream to write to
+    vector<char> buffer;  ///< Buffered data
+    size_t length;        ///< Number of buffered characters
+
+
+    /**
+     * Makes room in the buffer.
+     * @param[in] space Number of characters which are about to be written
+     */
+    void reserve(const size_t space);
+};
+
+#endif  // WRITER_H_
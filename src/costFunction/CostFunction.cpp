@@ -28,4 +28,18 @@ CostFunction::operator()(const Node &A, const Node &B) const {
     return cost(A, B);
 }
 
+
+void
+CostFunction::row(const Node &A, const Coordinates &B, double *costs) const {
+    for (size_t j = 0; j < B.size; j++) {
+        costs[j] = cost(A, Node(B.id[j], B.x[j], B.y[j]));
+    }
+}
+
+
+bool
+CostFunction::isSymmetric() const {
+    return false;
+}
+
 }  // namespace costFunction
@@ -17,11 +17,27 @@
 #define COSTFUNCTION_COSTFUNCTION_H_
 
 #include <cfloat>
+#include <cstddef>
 
 #include "../Node.h"
 
 namespace costFunction {
 
+/**
+ * A set of nodes, stored as contiguous arrays.
+ * Used to compute costs of many arcs with a single call.
+ */
+struct coordinates_s {
+    const unsigned int *id;  ///< Identifiers of the nodes
+    const double *x;         ///< X-coordinates of the nodes
+    const double *y;         ///< Y-coordinates of the nodes
+    size_t size;             ///< Number of nodes
+};
+
+/** Type of a set of nodes stored as contiguous arrays. */
+typedef struct coordinates_s Coordinates;
+
+
 /**
  * Associates a cost to an arc between two nodes.
  * No assumption is made on the costs of arcs. DBL_MAX is used to
@@ -29,7 +45,8 @@ namespace costFunction {
  * It is assumed that, given two nodes, every direct path between them
  * share the same cost.
  * Subclasses must implement the pure virtual member function "cost"
- * following the desired criterion.
+ * following the desired criterion, and may override "row" with a kernel
+ * computing many arcs at once.
  *
  * This class follows the Strategy Design Pattern.
  *
@@ -61,6 +78,26 @@ class CostFunction {
     virtual double cost(const Node &A, const Node &B) const = 0;
 
 
+    /**
+     * Returns costs of the arcs from a node to a set of nodes.
+     * Every cost must be equal to the one returned by "cost" on the same
+     * arc. Default implementation calls "cost" once per arc.
+     * @param[in]  A     Source node
+     * @param[in]  B     Target nodes
+     * @param[out] costs Cost of the arc from A to each node in B
+     */
+    virtual void row(const Node &A, const Coordinates &B, double *costs) const;
+
+
+    /**
+     * Tells whether the cost of an arc does not depend on its direction.
+     * Symmetric functions must return exactly the same cost for (A, B)
+     * and (B, A). Default implementation makes no assumption.
+     * @return True iff cost function is symmetric
+     */
+    virtual bool isSymmetric() const;
+
+
     static const double infinite;  ///< Infinite distance
 };
 
@@ -29,4 +29,22 @@ Euclidean::cost(const Node &A, const Node &B) const {
     return sqrt(D_x * D_x + D_y * D_y);
 }
 
+
+void
+Euclidean::row(const Node &A, const Coordinates &B, double *costs) const {
+    const double x = A.getX(), y = A.getY();
+
+    for (size_t j = 0; j < B.size; j++) {
+        const double D_x = x - B.x[j],
+                     D_y = y - B.y[j];
+        costs[j] = sqrt(D_x * D_x + D_y * D_y);
+    }
+}
+
+
+bool
+Euclidean::isSymmetric() const {
+    return true;
+}
+
 }  // namespace costFunction
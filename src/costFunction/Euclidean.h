@@ -44,6 +44,24 @@ class Euclidean: public CostFunction {
      * @return Cost of the arc between nodes A and B
      */
     virtual double cost(const Node &A, const Node &B) const;
+
+
+    /**
+     * Returns costs of the arcs from a node to a set of nodes.
+     * Loop runs on contiguous arrays, so that it can be vectorized.
+     * @param[in]  A     Source node
+     * @param[in]  B     Target nodes
+     * @param[out] costs Cost of the arc from A to each node in B
+     */
+    virtual void row(const Node &A, const Coordinates &B, double *costs) const;
+
+
+    /**
+     * Tells whether the cost of an arc does not depend on its direction.
+     * Euclidean distance is symmetric.
+     * @return True iff cost function is symmetric
+     */
+    virtual bool isSymmetric() const;
 };
 
 }  // namespace costFunction
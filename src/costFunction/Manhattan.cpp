@@ -29,4 +29,22 @@ Manhattan::cost(const Node &A, const Node &B) const {
     return D_x + D_y;
 }
 
+
+void
+Manhattan::row(const Node &A, const Coordinates &B, double *costs) const {
+    const double x = A.getX(), y = A.getY();
+
+    for (size_t j = 0; j < B.size; j++) {
+        const double D_x = std::abs(x - B.x[j]),
+                     D_y = std::abs(y - B.y[j]);
+        costs[j] = D_x + D_y;
+    }
+}
+
+
+bool
+Manhattan::isSymmetric() const {
+    return true;
+}
+
 }  // namespace costFunction
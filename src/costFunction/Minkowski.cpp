@@ -15,6 +15,7 @@
  */
 #include <math.h>
 
+#include <cfloat>
 #include <cmath>
 
 #include "Minkowski.h"
@@ -23,8 +24,110 @@ namespace costFunction {
 
 using std::abs;
 
-Minkowski::Minkowski(const double p):
-    p(p) {
+/** Largest p handled by the integer kernel. */
+static const double MAX_INTEGER_POWER = 64.0;
+
+
+/**
+ * Raises a non negative number to an integer power.
+ * @param[in] x Base
+ * @param[in] n Exponent, at least 1
+ * @return x to the power of n
+ */
+static inline double power_of(double x, unsigned int n) {
+    double result = 1.0;
+
+    while (n > 0) {
+        if (n & 1) {
+            result *= x;
+        }
+        x *= x;
+        n >>= 1;
+    }
+
+    return result;
+}
+
+
+/**
+ * Returns Minkowski distance given distances along axes.
+ * Kernel is a template parameter, so that it is resolved at compile
+ * time.
+ * @param[in] D_x   Distance along x axis
+ * @param[in] D_y   Distance along y axis
+ * @param[in] p     P-parameter
+ * @param[in] q     Inverse of the P-parameter
+ * @param[in] power P-parameter, for integer kernel
+ * @return Minkowski distance
+ */
+template <Minkowski::Kernel K>
+static inline double distance(
+    const double D_x,
+    const double D_y,
+    const double p,
+    const double q,
+    const unsigned int power) {
+    switch (K) {
+    case Minkowski::TAXICAB:
+        return D_x + D_y;
+
+    case Minkowski::EUCLIDEAN:
+        return sqrt(D_x * D_x + D_y * D_y);
+
+    case Minkowski::INTEGER:
+        return pow(power_of(D_x, power) + power_of(D_y, power), q);
+
+    case Minkowski::CHEBYSHEV:
+        return (D_x > D_y) ? D_x : D_y;
+
+    default:
+        return pow(pow(D_x, p) + pow(D_y, p), q);
+    }
+}
+
+
+/**
+ * Computes a row of Minkowski distances with a given kernel.
+ * @param[in]  x     X-coordinate of the source node
+ * @param[in]  y     Y-coordinate of the source node
+ * @param[in]  B     Target nodes
+ * @param[in]  p     P-parameter
+ * @param[in]  power P-parameter, for integer kernel
+ * @param[out] costs Distance from the source node to each target
+ */
+template <Minkowski::Kernel K>
+static void row_kernel(
+    const double x,
+    const double y,
+    const Coordinates &B,
+    const double p,
+    const unsigned int power,
+    double *costs) {
+    const double q = 1.0 / p;
+
+    for (size_t j = 0; j < B.size; j++) {
+        costs[j] = distance<K>(abs(x - B.x[j]), abs(y - B.y[j]), p, q, power);
+    }
+}
+
+
+
+Minkowski::Minkowski(const double p, const bool specialize):
+    p(p), kernel(GENERIC), power(0) {
+    if (!specialize) {
+        return;
+    }
+
+    if (p == 1.0) {
+        kernel = TAXICAB;
+    } else if (p == 2.0) {
+        kernel = EUCLIDEAN;
+    } else if (p > DBL_MAX) {
+        kernel = CHEBYSHEV;
+    } else if (p >= 1.0 && p <= MAX_INTEGER_POWER && p == floor(p)) {
+        kernel = INTEGER;
+        power  = static_cast<unsigned int>(p);
+    }
 }
 
 
@@ -35,9 +138,61 @@ Minkowski::~Minkowski() {
 double
 Minkowski::cost(const Node &A, const Node &B) const {
     const double D_x = abs(A.getX() - B.getX()),
-                 D_y = abs(A.getY() - B.getY()),
-                 sum = pow(D_x, p) + pow(D_y, p);
-    return pow(sum, 1.0 / p);
+                 D_y = abs(A.getY() - B.getY());
+
+    switch (kernel) {
+    case TAXICAB:
+        return distance<TAXICAB>(D_x, D_y, p, 1.0 / p, power);
+    case EUCLIDEAN:
+        return distance<EUCLIDEAN>(D_x, D_y, p, 1.0 / p, power);
+    case INTEGER:
+        return distance<INTEGER>(D_x, D_y, p, 1.0 / p, power);
+    case CHEBYSHEV:
+        return distance<CHEBYSHEV>(D_x, D_y, p, 1.0 / p, power);
+    default:
+        return distance<GENERIC>(D_x, D_y, p, 1.0 / p, power);
+    }
+}
+
+
+void
+Minkowski::row(const Node &A, const Coordinates &B, double *costs) const {
+    const double x = A.getX(), y = A.getY();
+
+    switch (kernel) {
+    case TAXICAB:
+        row_kernel<TAXICAB>(x, y, B, p, power, costs);
+        break;
+    case EUCLIDEAN:
+        row_kernel<EUCLIDEAN>(x, y, B, p, power, costs);
+        break;
+    case INTEGER:
+        row_kernel<INTEGER>(x, y, B, p, power, costs);
+        break;
+    case CHEBYSHEV:
+        row_kernel<CHEBYSHEV>(x, y, B, p, power, costs);
+        break;
+    default:
+        row_kernel<GENERIC>(x, y, B, p, power, costs);
+    }
+}
+
+
+Minkowski::Kernel
+Minkowski::getKernel() const {
+    return kernel;
+}
+
+
+double
+Minkowski::getP() const {
+    return p;
+}
+
+
+bool
+Minkowski::isSymmetric() const {
+    return true;
 }
 
 }  // namespace costFunction
@@ -30,18 +30,36 @@ namespace costFunction {
  * If you whish to use Manhattan or Euclidean distance, please use the
  * dedicated classes (for performance reasons).
  *
+ * A kernel is selected once, at construction: p = 1, p = 2, integer p
+ * and infinite p (Chebyshev distance) have specialized kernels which do
+ * not call pow on coordinates; other values use the generic formula.
+ * Specialized kernels agree with the generic formula up to rounding
+ * (exactly, when p = 1).
+ *
  * This class follows the Strategy Design Pattern.
  *
  * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
  */
 class Minkowski: public CostFunction {
  public:
+    /** Kernels computing the distance. */
+    enum Kernel {
+        GENERIC,    ///< Any p, with pow
+        TAXICAB,    ///< p = 1
+        EUCLIDEAN,  ///< p = 2
+        INTEGER,    ///< Integer p, by repeated multiplication
+        CHEBYSHEV   ///< Infinite p
+    };
+
+
     /**
      * Constructor.
      * Set the value of the paramter p.
-     * @param[in] p P-parameter of Minkowski distance
+     * @param[in] p          P-parameter of Minkowski distance
+     * @param[in] specialize Whether to select a kernel specialized on p,
+     *                       false always uses the generic formula
      */
-    explicit Minkowski(const double p);
+    explicit Minkowski(const double p, const bool specialize = true);
 
 
     /**
@@ -60,8 +78,42 @@ class Minkowski: public CostFunction {
     virtual double cost(const Node &A, const Node &B) const;
 
 
+    /**
+     * Returns costs of the arcs from a node to a set of nodes.
+     * Kernel is selected once per row.
+     * @param[in]  A     Source node
+     * @param[in]  B     Target nodes
+     * @param[out] costs Cost of the arc from A to each node in B
+     */
+    virtual void row(const Node &A, const Coordinates &B, double *costs) const;
+
+
+    /**
+     * Tells whether the cost of an arc does not depend on its direction.
+     * Minkowski distance is symmetric, for every P-parameter.
+     * @return True iff cost function is symmetric
+     */
+    virtual bool isSymmetric() const;
+
+
+    /**
+     * Returns kernel used to compute the distance.
+     * @return Kernel used to compute the distance
+     */
+    Kernel getKernel() const;
+
+
+    /**
+     * Returns the P-parameter of the distance.
+     * @return P-parameter of the Minkowski distance
+     */
+    double getP() const;
+
+
  private:
-    const double p;  ///< P-parameter of the Minkowski distance
+    const double p;      ///< P-parameter of the Minkowski distance
+    Kernel kernel;       ///< Kernel computing the distance
+    unsigned int power;  ///< P-parameter, for integer kernel
 };
 
 }  // namespace costFunction
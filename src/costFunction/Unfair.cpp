@@ -13,22 +13,45 @@
  * You should have received a copy of the GNU General Public License
  * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <math.h>
+
 #include <cmath>
 
 #include "Unfair.h"
-#include "Minkowski.h"
-#include "../RNG.h"
 
 using std::abs;
 
+/** Two times pi. */
+static const double TWO_PI = 6.283185307179586476925286766559;
+
+/** Scales a 53 bits integer to [0, 1). */
+static const double TWO_TO_MINUS_53 = 1.0 / 9007199254740992.0;
+
+
+/**
+ * Mixes bits of a 64 bits integer.
+ * This is the finalizer of SplitMix64: a bijection whose output looks
+ * random even for consecutive inputs.
+ * @param[in] z Integer to mix
+ * @return Mixed integer
+ */
+static inline uint64_t mix(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+
 namespace costFunction {
 
 Unfair::Unfair(
         const double p,
         const double mi,
         const double sigma,
-        const double t):
-p(p), mi(mi), sigma(sigma), t(t) {
+        const double t,
+        const uint64_t seed):
+minkowski(p), mi(mi), sigma(sigma), t(t), seed(seed) {
 }
 
 
@@ -42,11 +65,76 @@ Unfair::cost(const Node &A, const Node &B) const {
         return 0.0;
     }
 
-    Minkowski minkowski(p);
-    RNG rng(A.getId() - B.getId());
-
-    const double cost = abs(minkowski(A, B) + rng.normal(mi, sigma));
+    const double cost = abs(minkowski(A, B) + noise(A.getId(), B.getId()));
     return (cost <= t) ? cost : CostFunction::infinite;
 }
 
+
+void
+Unfair::row(const Node &A, const Coordinates &B, double *costs) const {
+    minkowski.row(A, B, costs);
+    for (size_t j = 0; j < B.size; j++) {
+        if (A.getId() == B.id[j]) {
+            costs[j] = 0.0;
+            continue;
+        }
+
+        const double cost = abs(costs[j] + noise(A.getId(), B.id[j]));
+        costs[j] = (cost <= t) ? cost : CostFunction::infinite;
+    }
+}
+
+
+/**
+ * Ordered pair of identifiers is a 64 bits counter, which is mixed with
+ * the seed; two uniform numbers are taken from the result and turned
+ * into a normal one by the Box-Muller transform.
+ */
+double
+Unfair::noise(const unsigned int A, const unsigned int B) const {
+    const uint64_t counter = (static_cast<uint64_t>(A) << 32) | B,
+                   first   = mix(seed ^ mix(counter)),
+                   second  = mix(first);
+    const double U1 = ((first >> 11) + 0.5) * TWO_TO_MINUS_53,
+                 U2 = (second >> 11) * TWO_TO_MINUS_53;
+
+    return mi + sigma * sqrt(-2.0 * log(U1)) * cos(TWO_PI * U2);
+}
+
+
+bool
+Unfair::isSymmetric() const {
+    return sigma == 0.0;
+}
+
+
+double
+Unfair::getP() const {
+    return minkowski.getP();
+}
+
+
+double
+Unfair::getMean() const {
+    return mi;
+}
+
+
+double
+Unfair::getVariance() const {
+    return sigma;
+}
+
+
+double
+Unfair::getThreshold() const {
+    return t;
+}
+
+
+uint64_t
+Unfair::getSeed() const {
+    return seed;
+}
+
 }  // namespace costFunction
@@ -16,7 +16,10 @@
 #ifndef COSTFUNCTION_UNFAIR_H_
 #define COSTFUNCTION_UNFAIR_H_
 
+#include <stdint.h>
+
 #include "CostFunction.h"
+#include "Minkowski.h"
 
 namespace costFunction {
 
@@ -29,7 +32,11 @@ namespace costFunction {
  *
  * In order to make cost matrix no longer symmetric, a random component
  * is added to each computed distance (normal distribution is used).
- * 
+ * Random components are drawn from a stateless counter-based generator,
+ * keyed by a seed and by the ordered pair of identifiers: the cost of an
+ * arc never depends on which arcs were computed before, so that costs
+ * can be computed in any order, in parallel or on demand.
+ *
  * In order to make the graph no longer connected, arcs longer than a
  * given threshold are removed.
  *
@@ -45,12 +52,14 @@ class Unfair: public CostFunction {
      * @param[in] mi    Mean of the random component
      * @param[in] sigma Variance of the random component
      * @param[in] t     Threshold above which an arc is removed
+     * @param[in] seed  Seed of the random components
      */
     Unfair(
         const double p,
         const double mi,
         const double sigma,
-        const double t);
+        const double t,
+        const uint64_t seed = 0);
 
 
     /**
@@ -71,11 +80,75 @@ class Unfair: public CostFunction {
     virtual double cost(const Node &A, const Node &B) const;
 
 
+    /**
+     * Returns costs of the arcs from a node to a set of nodes.
+     * Distances are computed by a Minkowski row, then perturbed.
+     * @param[in]  A     Source node
+     * @param[in]  B     Target nodes
+     * @param[out] costs Cost of the arc from A to each node in B
+     */
+    virtual void row(const Node &A, const Coordinates &B, double *costs) const;
+
+
+    /**
+     * Tells whether the cost of an arc does not depend on its direction.
+     * Costs are symmetric only when random components have no
+     * variance.
+     * @return True iff cost function is symmetric
+     */
+    virtual bool isSymmetric() const;
+
+
+    /**
+     * Returns the P-parameter of the Minkowski distance.
+     * @return P-parameter of the Minkowski distance
+     */
+    double getP() const;
+
+
+    /**
+     * Returns the mean of the random component.
+     * @return Mean of the random component
+     */
+    double getMean() const;
+
+
+    /**
+     * Returns the variance of the random component.
+     * @return Variance of the random component
+     */
+    double getVariance() const;
+
+
+    /**
+     * Returns the threshold above which an arc is removed.
+     * @return Threshold above which an arc is removed
+     */
+    double getThreshold() const;
+
+
+    /**
+     * Returns the seed of the random components.
+     * @return Seed of the random components
+     */
+    uint64_t getSeed() const;
+
+
  private:
-    const double p;      ///< Minkowski P-parameter
-    const double mi;     ///< Mean of normal distribution
-    const double sigma;  ///< Variance of normal distribution
-    const double t;      ///< Threshold above which an arc is removed
+    const Minkowski minkowski;  ///< Minkowski distance
+    const double mi;            ///< Mean of normal distribution
+    const double sigma;         ///< Variance of normal distribution
+    const double t;             ///< Threshold above which an arc is removed
+    const uint64_t seed;        ///< Seed of the random components
+
+
+    /**
+     * Returns the random component of the cost of an arc.
+     * @param[in] A Identifier of the source node
+     * @param[in] B Identifier of the target node
+     * @return Random component, from a normal distribution
+     */
+    double noise(const unsigned int A, const unsigned int B) const;
 };
 
 }  // namespace costFunction
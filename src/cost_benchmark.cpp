@@ -0,0 +1,205 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdint.h>
+
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "Stopwatch.h"
+#include "Panel.h"
+#include "RNG.h"
+#include "perturbator/Null.h"
+#include "generator/Uniform.h"
+#include "costFunction/Minkowski.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using costFunction::Coordinates;
+using costFunction::Minkowski;
+
+
+/**
+ * Prints the helper.
+ * @param[in] argc ARGument Counter
+ * @param[in] argv ARGument Vector
+ */
+static void show_helper(int argc, char *argv[]) {
+    (void) argc;
+    cout << "COST BENCHMARK\n"
+         << "Measures the time needed to compute a cost matrix with the "
+         << "Minkowski distance, using the generic formula and the kernel "
+         << "specialized on the P-parameter.\n"
+         << "Results are written to standard output.\n"
+         << endl
+         << "Usage:\n"
+         << "  " << argv[0] << " -N <int> -p <num> -r <int> -h\n"
+         << endl
+         << "Options:\n"
+         << "  -N <int> \t Number of nodes (default: 2000)\n"
+         << "  -p <num> \t Minkowski P-parameter, 0 for infinity (default:\n"
+         << "           \t runs 1, 2, 3 and infinity)\n"
+         << "  -r <int> \t Seed of the nodes (default: depends on time and\n"
+         << "           \t process)\n"
+         << "  -h       \t Prints this help and exit\n"
+         << endl
+         << "Environment:\n"
+         << "  MEMOC_THREADS \t Number of threads (default: number of\n"
+         << "                \t online processors)\n";
+}
+
+
+/**
+ * Computes a whole cost matrix, a row at a time.
+ * @param[in]  cost    Cost function
+ * @param[in]  nodes   Nodes
+ * @param[in]  targets Nodes, as contiguous arrays
+ * @param[out] costs   Cost matrix, row major
+ * @return User time, in seconds
+ */
+static double measure(
+    const Minkowski &cost,
+    const vector<Node> &nodes,
+    const Coordinates &targets,
+    vector<double> *costs) {
+    const size_t N = nodes.size();
+    Stopwatch sw;
+
+    sw.start();
+    for (size_t i = 0; i < N; i++) {
+        cost.row(nodes[i], targets, &(*costs)[i * N]);
+    }
+
+    return sw.stop().getUserTime();
+}
+
+
+/**
+ * Compares generic and specialized kernels on a P-parameter.
+ * Error is not reported for infinite P, since the generic formula does
+ * not converge to the Chebyshev distance in floating point.
+ * @param[in] p       P-parameter
+ * @param[in] nodes   Nodes
+ * @param[in] targets Nodes, as contiguous arrays
+ */
+static void compare(
+    const double p,
+    const vector<Node> &nodes,
+    const Coordinates &targets) {
+    static const char *KERNELS[] = {
+        "generic", "taxicab", "euclidean", "integer", "chebyshev"
+    };
+    const size_t N = nodes.size();
+    const Minkowski generic(p, false), specialized(p);
+    vector<double> A(N * N), B(N * N);
+    double error = 0.0;
+
+    const double t_generic     = measure(generic, nodes, targets, &A),
+                 t_specialized = measure(specialized, nodes, targets, &B);
+
+    for (size_t i = 0; i < N * N; i++) {
+        if (A[i] > 0.0) {
+            const double relative = std::abs(A[i] - B[i]) / A[i];
+            error = (relative > error) ? relative : error;
+        }
+    }
+
+    printf("p = %-4g kernel = %-10s generic: %8.4f s  "
+           "specialized: %8.4f s  speedup: %6.2fx",
+           p, KERNELS[specialized.getKernel()], t_generic, t_specialized,
+           t_generic / t_specialized);
+    if (p <= DBL_MAX) {
+        printf("  max rel. error: %g", error);
+    }
+    printf("\n");
+}
+
+
+
+/**
+ * Runs the benchmark.
+ * @param[in] argc ARGument Counter
+ * @param[in] argv ARGument Vector
+ * @return EXIT_SUCCESS in case of success
+ */
+int main(int argc, char *argv[]) {
+    int opt;
+    unsigned int N = 2000;
+    double p = -1.0;
+    bool seeded = false;
+    uint64_t seed = 0;
+
+    /*******************************************************************
+     * Command line options parsing.
+     ******************************************************************/
+    while ((opt = getopt(argc, argv, "N:p:r:h")) != -1) {
+        switch (opt) {
+        case 'N': N = atoi(optarg); break;
+        case 'p': p = atof(optarg); break;
+        case 'r': seed = strtoull(optarg, NULL, 10); seeded = true; break;
+        case 'h':
+            show_helper(argc, argv);
+            exit(EXIT_SUCCESS);
+            break;
+        default:
+            cout << "Unrecognized option. Run with -h to see the helper.\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+
+
+    /*******************************************************************
+     * Runs the benchmark.
+     ******************************************************************/
+    if (seeded) {
+        RNG::setMasterSeed(seed);
+    }
+
+    Panel panel(200.0, 100.0);
+    perturbator::Null perturbator;
+    generator::Uniform generator(perturbator);
+    const vector<Node> nodes(generator(panel, N));
+
+    vector<unsigned int> id(N);
+    vector<double> x(N), y(N);
+    for (size_t i = 0; i < N; i++) {
+        id[i] = nodes[i].getId();
+        x[i]  = nodes[i].getX();
+        y[i]  = nodes[i].getY();
+    }
+    Coordinates targets;
+    targets.id   = &id[0];
+    targets.x    = &x[0];
+    targets.y    = &y[0];
+    targets.size = N;
+
+    if (p >= 0.0) {
+        compare((p == 0.0) ? HUGE_VAL : p, nodes, targets);
+    } else {
+        compare(1.0, nodes, targets);
+        compare(2.0, nodes, targets);
+        compare(3.0, nodes, targets);
+        compare(HUGE_VAL, nodes, targets);
+    }
+
+    return EXIT_SUCCESS;
+}
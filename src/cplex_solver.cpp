@@ -44,9 +44,18 @@ static void show_helper(int argc, char *argv[]) {
          << "standard output.\n"
          << endl
          << "Usage:\n"
-         << "  " << argv[0] << " -h" << endl
+         << "  " << argv[0] << " -r <int> -f <file> -h" << endl
          << endl
-         << "  -h    \t Prints this help and exits\n";
+         << "Options:\n"
+         << "  -r <int>  \t Seed of the random numbers used by CPLEX\n"
+         << "            \t (default: CPLEX default)\n"
+         << "  -f <file> \t Reads instance from file instead of standard\n"
+         << "            \t input (binary instances are memory-mapped)\n"
+         << "  -h        \t Prints this help and exits\n"
+         << endl
+         << "Environment:\n"
+         << "  MEMOC_THREADS \t Number of threads (default: number of\n"
+         << "                \t online processors)\n";
 }
 
 
@@ -59,12 +68,16 @@ static void show_helper(int argc, char *argv[]) {
  */
 int main(int argc, char *argv[]) {
     int opt;
+    const char *path = NULL;
+    int seed = -1;
 
     /*******************************************************************
      * Command line options parsing.
      ******************************************************************/
-    while ((opt = getopt(argc, argv, "h")) != -1) {
+    while ((opt = getopt(argc, argv, "r:f:h")) != -1) {
         switch (opt) {
+        case 'r': seed = atoi(optarg); break;
+        case 'f': path = optarg; break;
         case 'h':
             show_helper(argc, argv);
             exit(EXIT_SUCCESS);
@@ -81,8 +94,10 @@ int main(int argc, char *argv[]) {
      * Runs the solver.
      ******************************************************************/
     Stopwatch sw;
-    Instance instance = Instance::load(&std::cin);
-    solver::CPLEX solver;
+    Instance instance = (path != NULL)
+                      ? Instance::open(path)
+                      : Instance::load(&std::cin);
+    solver::CPLEX solver(seed);
 
     sw.start();
     Solution solution = solver(instance);
@@ -17,10 +17,12 @@
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <stdint.h>
 
 #include <iostream>
 
 #include "Stopwatch.h"
+#include "RNG.h"
 #include "Instance.h"
 #include "Solution.h"
 #include "solver/AGLSA.h"
@@ -46,7 +48,8 @@ static void show_helper(int argc, char *argv[]) {
          << endl
          << "Usage:\n"
          << "  " << argv[0] << " -c <double> -m <double> -t <double> "
-         << "-p <double> -h" << endl
+         << "-p <double> -i <double> -o <int> -l <int> -e <type> -s <type> "
+         << "-k <int> -r <int> -f <file> -h" << endl
          << endl
          << "Options:\n"
          << "  -c <double> \t Maximum probability of crossover (default: 0.8)\n"
@@ -57,12 +60,37 @@ static void show_helper(int argc, char *argv[]) {
          << "              \t is already a similar one (default: 0.5)\n"
          << "  -i <double> \t Probability of improving a good chromosome\n"
          << "              \t (default: 0.2)\n"
+         << "  -o <int>    \t Longest portion, up to 3, relocated by Or-opt\n"
+         << "              \t while improving, 0 disables it (default: 3)\n"
+         << "  -l <int>    \t Longest chain of moves of the Lin-Kernighan\n"
+         << "              \t search while improving, 0 disables it\n"
+         << "              \t (default: 0)\n"
          << "  -T <double> \t Maximum execution time, in secs (default 5.0)\n"
          << "  -M <int>    \t Maximum number of iterations (default: 10000)\n"
          << "  -K <int>    \t Maximum number of consecutive iterations\n"
          << "              \t without improvevement (default: 1000)\n"
          << "  -S <int>    \t Maximum size of the population (default: 30)\n"
-         << "  -h          \t Prints this help and exits\n";
+         << "  -e <type>   \t Type of the stored costs: double, float or\n"
+         << "              \t int, scaled 32 bits integers (default: double)\n"
+         << "  -s <type>   \t Storage of the costs: dense, sparse, for\n"
+         << "              \t instances missing most arcs, or triangular,\n"
+         << "              \t for symmetric ones; sparse costs are always\n"
+         << "              \t doubles, other types make triangular costs\n"
+         << "              \t dense (default: as loaded)\n"
+         << "  -k <int>    \t Candidate neighbours per node used by the\n"
+         << "              \t heuristics and the local search; 0 makes\n"
+         << "              \t the local search try every 2-opt move\n"
+         << "              \t (default: 10)\n"
+         << "  -r <int>    \t Seed of the random numbers (default: depends\n"
+         << "              \t on time and process)\n"
+         << "  -f <file>   \t Reads instance from file instead of standard\n"
+         << "              \t input (binary instances are memory-mapped,\n"
+         << "              \t those saving a cost function are lazy)\n"
+         << "  -h          \t Prints this help and exits\n"
+         << endl
+         << "Environment:\n"
+         << "  MEMOC_THREADS \t Number of threads (default: number of\n"
+         << "                \t online processors)\n";
 }
 
 
@@ -81,24 +109,64 @@ int main(int argc, char *argv[]) {
            p_accept        = 0.5,
            p_improvement   = 0.2,
            max_time        = 5.0;
-    unsigned int max_iter  = 10000,
-                 max_slack = 1000,
-                 max_size  = 30;
+    unsigned int max_iter   = 10000,
+                 max_slack  = 1000,
+                 max_size   = 30,
+                 candidates = 10,
+                 or_opt     = 3,
+                 depth      = 0;
+    const char *path       = NULL;
+    bool seeded            = false;
+    uint64_t seed          = 0;
+    Instance::Precision precision = Instance::DOUBLE;
+    Instance::Storage storage     = Instance::DENSE;
+    bool converted                = false;
 
     /*******************************************************************
      * Command line options parsing.
      ******************************************************************/
-    while ((opt = getopt(argc, argv, "c:m:t:p:i:T:M:K:S:h")) != -1) {
+    const char *options = "c:m:t:p:i:o:l:T:M:K:S:e:s:k:r:f:h";
+    while ((opt = getopt(argc, argv, options)) != -1) {
         switch (opt) {
         case 'c': p_crossover   = atof(optarg); break;
         case 'm': p_mutation    = atof(optarg); break;
         case 't': d_threshold   = atof(optarg); break;
         case 'p': p_accept      = atof(optarg); break;
         case 'i': p_improvement = atof(optarg); break;
+        case 'o': or_opt        = atoi(optarg); break;
+        case 'l': depth         = atoi(optarg); break;
         case 'T': max_time      = atof(optarg); break;
         case 'M': max_iter      = atoi(optarg); break;
         case 'K': max_slack     = atoi(optarg); break;
         case 'S': max_size      = atoi(optarg); break;
+        case 'k': candidates    = atoi(optarg); break;
+        case 'r': seed = strtoull(optarg, NULL, 10); seeded = true; break;
+        case 'f': path          = optarg;       break;
+        case 'e':
+            if (strcmp(optarg, "double") == 0) {
+                precision = Instance::DOUBLE;
+            } else if (strcmp(optarg, "float") == 0) {
+                precision = Instance::FLOAT;
+            } else if (strcmp(optarg, "int") == 0) {
+                precision = Instance::FIXED;
+            } else {
+                cout << "Unrecognized type of costs: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 's':
+            converted = true;
+            if (strcmp(optarg, "dense") == 0) {
+                storage = Instance::DENSE;
+            } else if (strcmp(optarg, "sparse") == 0) {
+                storage = Instance::SPARSE;
+            } else if (strcmp(optarg, "triangular") == 0) {
+                storage = Instance::TRIANGULAR;
+            } else {
+                cout << "Unrecognized storage of costs: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
         case 'h':
             show_helper(argc, argv);
             exit(EXIT_SUCCESS);
@@ -115,14 +183,27 @@ int main(int argc, char *argv[]) {
     config.threshold       = d_threshold;
     config.P               = p_accept;
     config.p_improvement   = p_improvement;
+    config.or_opt          = or_opt;
+    config.depth           = depth;
 
 
 
     /*******************************************************************
      * Runs the solver.
      ******************************************************************/
+    if (seeded) {
+        RNG::setMasterSeed(seed);
+    }
+
     Stopwatch sw;
-    Instance instance = Instance::load(&std::cin);
+    Instance instance = (path != NULL)
+                      ? Instance::open(path)
+                      : Instance::load(&std::cin);
+    if (converted) {
+        instance.setStorage(storage);
+    }
+    instance.setPrecision(precision);
+    instance.buildCandidates(candidates);
     solver::AGLSA solver(config, max_time, max_iter, max_slack, max_size);
 
     sw.start();
@@ -17,19 +17,53 @@
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <stdint.h>
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <vector>
 
+#include "Node.h"
 #include "Panel.h"
+#include "Parallel.h"
+#include "RNG.h"
 #include "perturbator/Normal.h"
+#include "perturbator/Uniform.h"
+#include "perturbator/Chain.h"
 #include "generator/Uniform.h"
+#include "generator/Line.h"
+#include "generator/SuperEllipse.h"
+#include "generator/Cluster.h"
+#include "generator/Grid.h"
+#include "generator/Mixed.h"
 #include "costFunction/Unfair.h"
 #include "Instance.h"
 
 using std::cout;
 using std::endl;
+using std::vector;
+
+
+/** Instances to generate in batch mode. */
+struct batch_s {
+    vector<unsigned int> sizes;             ///< Sizes of the instances
+    unsigned int count;                     ///< Instances per size
+    const char *directory;                  ///< Output directory
+    const Panel *panel;                     ///< Panel of the instances
+    const generator::Generator *generator;  ///< Generator of the nodes
+    double p;                               ///< Minkowski P-parameter
+    double mi;                              ///< Mean of the noise
+    double sigma;                           ///< Variance of the noise
+    double t;                               ///< Threshold of the arcs
+    uint64_t seed;                          ///< Seed of the batch
+    bool binary;                            ///< Whether to write binary
+    bool lazy;                              ///< Whether to save functions
+    unsigned int failures;                  ///< Instances not written
+};
+
+/** Type of the instances to generate in batch mode. */
+typedef struct batch_s Batch;
 
 
 /**
@@ -41,7 +75,8 @@ static void show_helper(int argc, char *argv[]) {
     (void) argc;
     cout << "INSTANCE GENERATOR\n"
          << "Use this tool to generate an instance of a TSP problem.\n"
-         << "Instance is printed to standard output.\n"
+         << "Instance is printed to standard output; in batch mode, "
+         << "instances are written in a directory, in parallel.\n"
          << "This generator uses a function to generate nodes and distances "
          << "trying to complicate the problem: distance matrix is not "
          << "symmetric, graph is not connected, triangular inequality is "
@@ -51,20 +86,135 @@ static void show_helper(int argc, char *argv[]) {
          << endl
          << "Usage:\n"
          << "  " << argv[0] << " -N <int> -X <num> -Y <num> "
-         << "-M <num> -S <num> "
-         << "-p <num> -m <num> -s <num> -t <num> -h\n"
+         << "-M <num> -S <num> -j <num> "
+         << "-p <num> -m <num> -s <num> -t <num> -r <int> -l <num> "
+         << "-w -b -d <dir> -n <int> -g <type> -c <int> -e <num> "
+         << "-z <num> -q <num> -h\n"
          << endl
          << "Options:\n"
          << "  -N <int> \t Number of nodes in the instance (default: 10)\n"
+         << "           \t In batch mode, a list of sizes such as 50,60,70\n"
+         << "           \t or 10:80:10 (from 10 to 80, step 10)\n"
          << "  -x <num> \t Width of the panel (default: 200.0)\n"
          << "  -y <num> \t Height of the panel (default: 100.0)\n"
          << "  -M <num> \t Mean of the perturbation\n"
          << "  -S <num> \t Variance of the perturbation\n"
+         << "  -j <num> \t Magnitude of an uniform jitter applied after the\n"
+         << "           \t perturbation (default: 0.0, none)\n"
          << "  -p <num> \t Minkowski P-parameter (default: 1.0)\n"
          << "  -m <num> \t Mean of the random parameter in cost function\n"
          << "  -s <num> \t Variance of the random parameter in cost function\n"
+         << "           \t (0 gives a symmetric matrix, stored as a triangle)\n"
          << "  -t <num> \t Threshold over which an arc is removed\n"
-         << "  -h       \t Prints this help and exit\n";
+         << "  -r <int> \t Seed of nodes and of the random parameter in\n"
+         << "           \t cost function (default: 0, random nodes)\n"
+         << "  -l <num> \t Computes costs on demand while writing, caching\n"
+         << "           \t at most <num> MB of them (for very large panels);\n"
+         << "           \t binary instances save the cost function instead\n"
+         << "           \t of the costs, and solvers load them lazily\n"
+         << "  -w       \t Streams costs while writing, without building\n"
+         << "           \t the instance (for huge panels)\n"
+         << "  -b       \t Writes instance in binary format\n"
+         << "  -d <dir> \t Batch mode: writes instance k of size N in\n"
+         << "           \t <dir>/N_k.instance, seeded with r + N * n + k - 1\n"
+         << "  -n <int> \t Instances per size in batch mode (default: 1)\n"
+         << "  -g <type>\t Distribution of the nodes: uniform, line,\n"
+         << "           \t ellipse, cluster, grid or mixed, clusters and\n"
+         << "           \t grid together (default: uniform)\n"
+         << "  -c <int> \t Number of clusters (default: 10)\n"
+         << "  -e <num> \t Deviation of the clusters, relative to the\n"
+         << "           \t shorter side of the panel (default: 0.02)\n"
+         << "  -z <num> \t Fraction of empty grid cells (default: 0.2)\n"
+         << "  -q <num> \t Fraction of clustered nodes in mixed panels\n"
+         << "           \t (default: 0.5)\n"
+         << "  -h       \t Prints this help and exit\n"
+         << endl
+         << "Environment:\n"
+         << "  MEMOC_THREADS \t Number of threads (default: number of\n"
+         << "                \t online processors)\n";
+}
+
+
+
+/**
+ * Parses a list of sizes.
+ * List is made of comma separated items, each either a size or a range
+ * first:last:step. Terminates the program if list is not valid.
+ * @param[in] list List to parse
+ * @return Sizes in the list
+ */
+static vector<unsigned int> parse_sizes(const char *list) {
+    vector<unsigned int> sizes;
+    const char *cursor = list;
+
+    while (*cursor != '\0') {
+        char *end;
+        uint64_t first = strtoul(cursor, &end, 10),
+                 last  = first,
+                 step  = 1;
+        bool valid = end != cursor;
+        if (valid && *end == ':') {
+            cursor = end + 1;
+            last   = strtoul(cursor, &end, 10);
+            valid  = end != cursor && *end == ':';
+            cursor = end + 1;
+            step   = valid ? strtoul(cursor, &end, 10) : 0;
+            valid  = valid && end != cursor && step > 0;
+        }
+        if (!valid || (*end != ',' && *end != '\0')) {
+            cout << "Invalid list of sizes: " << list << "\n";
+            exit(EXIT_FAILURE);
+        }
+        for (uint64_t N = first; N <= last; N += step) {
+            sizes.push_back(N);
+        }
+        cursor = (*end == ',') ? end + 1 : end;
+    }
+
+    return sizes;
+}
+
+
+/**
+ * Generates and writes an instance of a batch.
+ * Random numbers of the calling thread restart from the seed of the
+ * instance, so that the instance does not depend on the thread nor on
+ * the other instances.
+ * @param[in]      task     Index of the instance in the batch
+ * @param[in, out] argument Pointer to the batch
+ */
+static void batch_task(const size_t task, void *argument) {
+    Batch *batch = reinterpret_cast<Batch *>(argument);
+    const unsigned int N = batch->sizes[task / batch->count],
+                       k = task % batch->count + 1;
+    const uint64_t seed = batch->seed
+                        + static_cast<uint64_t>(N) * batch->count + k - 1;
+    std::ostringstream path;
+
+    path << batch->directory << "/" << N << "_" << k << ".instance";
+    std::ofstream file(path.str().c_str(), std::ios::out | std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "[%s: %d]: %s: Cannot open file.\n",
+                __FILE__, __LINE__, path.str().c_str());
+        __sync_fetch_and_add(&batch->failures, 1);
+        return;
+    }
+
+    RNG::setSeed(seed);
+    costFunction::Unfair cost_function(
+        batch->p, batch->mi, batch->sigma, batch->t, seed);
+    if (batch->lazy) {
+        Instance(
+            (*batch->generator)(*batch->panel, N),
+            cost_function,
+            Instance::LAZY).saveBinary(&file);
+        return;
+    }
+    Instance::write(
+        (*batch->generator)(*batch->panel, N),
+        cost_function,
+        &file,
+        batch->binary);
 }
 
 
@@ -81,31 +231,57 @@ int main(int argc, char *argv[]) {
     /*******************************************************************
      * Default values for paramters.
      ******************************************************************/
-    unsigned int N = 10;
+    const char *sizes     = "10",
+               *directory = NULL,
+               *type      = "uniform";
+    unsigned int count    = 1,
+                 clusters = 10;
+    uint64_t seed  = 0;
     double X       = 200.0,
            Y       = 100.0,
            pMi     = 0.0,
            pSigma  = 1.0,
+           jitter  = 0.0,
            cP      = 1.0,
            cMi     = 0.0,
            cSigma  = 5.0,
-           cT      = 200.0;
+           cT      = 200.0,
+           budget  = 0.0,
+           spread  = 0.02,
+           missing = 0.2,
+           share   = 0.5;
+    bool stream    = false,
+         binary    = false,
+         seeded    = false;
 
 
     /*******************************************************************
      * Command line options parsing.
      ******************************************************************/
-    while ((opt = getopt(argc, argv, "N:x:y:M:S::p:m:s:t:h")) != -1) {
+    const char *options = "N:x:y:M:S::j:p:m:s:t:r:l:wbd:n:g:c:e:z:q:h";
+    while ((opt = getopt(argc, argv, options)) != -1) {
         switch (opt) {
-        case 'N': N      = atoi(optarg); break;
+        case 'N': sizes  = optarg;       break;
         case 'x': X      = atof(optarg); break;
         case 'y': Y      = atof(optarg); break;
         case 'M': pMi    = atof(optarg); break;
         case 'S': pSigma = atof(optarg); break;
+        case 'j': jitter = atof(optarg); break;
         case 'p': cP     = atof(optarg); break;
         case 'm': cMi    = atof(optarg); break;
         case 's': cSigma = atof(optarg); break;
         case 't': cT     = atof(optarg); break;
+        case 'r': seed   = strtoull(optarg, NULL, 10); seeded = true; break;
+        case 'l': budget = atof(optarg); break;
+        case 'w': stream = true;         break;
+        case 'b': binary = true;         break;
+        case 'd': directory = optarg;    break;
+        case 'n': count  = atoi(optarg); break;
+        case 'g': type   = optarg;       break;
+        case 'c': clusters = atoi(optarg); break;
+        case 'e': spread = atof(optarg); break;
+        case 'z': missing = atof(optarg); break;
+        case 'q': share  = atof(optarg); break;
         case 'h':
             show_helper(argc, argv);
             exit(EXIT_SUCCESS);
@@ -121,12 +297,89 @@ int main(int argc, char *argv[]) {
      * Runs generator or solver.
      ******************************************************************/
     Panel panel(X, Y);
-    perturbator::Normal perturbator(pMi, pSigma);
-    generator::Uniform generator(perturbator);
-    costFunction::Unfair cost_function(cP, cMi, cSigma, cT);
-    Instance instance(generator(panel, N), cost_function);
+    perturbator::Normal normal(pMi, pSigma);
+    perturbator::Uniform uniform_jitter(jitter);
+    perturbator::Chain chain(normal, uniform_jitter);
+    const perturbator::Perturbator &perturbator =
+        (jitter > 0.0)
+        ? static_cast<const perturbator::Perturbator &>(chain)
+        : static_cast<const perturbator::Perturbator &>(normal);
+    generator::Uniform uniform(perturbator);
+    generator::Line line(perturbator);
+    generator::SuperEllipse ellipse(perturbator);
+    generator::Cluster cluster(perturbator, clusters, spread);
+    generator::Grid grid(perturbator, missing);
+    generator::Mixed mixed(cluster, grid, share);
+    const generator::Generator *selected = NULL;
+    if (strcmp(type, "uniform") == 0) {
+        selected = &uniform;
+    } else if (strcmp(type, "line") == 0) {
+        selected = &line;
+    } else if (strcmp(type, "ellipse") == 0) {
+        selected = &ellipse;
+    } else if (strcmp(type, "cluster") == 0) {
+        selected = &cluster;
+    } else if (strcmp(type, "grid") == 0) {
+        selected = &grid;
+    } else if (strcmp(type, "mixed") == 0) {
+        selected = &mixed;
+    } else {
+        cout << "Unknown distribution: " << type << "\n";
+        exit(EXIT_FAILURE);
+    }
+    const generator::Generator &generator = *selected;
+    const vector<unsigned int> list = parse_sizes(sizes);
 
-    instance.save(&std::cout);
+    if (directory != NULL) {
+        Batch batch;
+        batch.sizes     = list;
+        batch.count     = (count > 0) ? count : 1;
+        batch.directory = directory;
+        batch.panel     = &panel;
+        batch.generator = &generator;
+        batch.p         = cP;
+        batch.mi        = cMi;
+        batch.sigma     = cSigma;
+        batch.t         = cT;
+        batch.seed      = seed;
+        batch.binary    = binary;
+        batch.lazy      = binary && budget > 0.0;
+        batch.failures  = 0;
+        Parallel::run(list.size() * batch.count, batch_task, &batch);
+        return (batch.failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (list.size() != 1) {
+        cout << "A single size is allowed outside batch mode.\n";
+        exit(EXIT_FAILURE);
+    }
+    const unsigned int N = list[0];
+    if (seeded) {
+        RNG::setSeed(seed);
+    }
+    costFunction::Unfair cost_function(cP, cMi, cSigma, cT, seed);
+    if (stream) {
+        Instance::write(generator(panel, N), cost_function, &cout, binary);
+        return EXIT_SUCCESS;
+    }
+
+    Instance::Storage storage = Instance::DENSE;
+    if (budget > 0.0) {
+        storage = Instance::LAZY;
+    } else if (cost_function.isSymmetric()) {
+        storage = Instance::TRIANGULAR;
+    }
+    Instance instance(
+        generator(panel, N),
+        cost_function,
+        storage,
+        static_cast<size_t>(budget * 1024.0 * 1024.0));
+
+    if (binary) {
+        instance.saveBinary(&std::cout);
+    } else {
+        instance.save(&std::cout);
+    }
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+
+#include "Cluster.h"
+#include "../NodeSet.h"
+#include "../RNG.h"
+
+namespace generator {
+
+/**
+ * Clamps a value to an interval.
+ * @param[in] value Value to clamp
+ * @param[in] min   Minimum allowed value
+ * @param[in] max   Maximum allowed value
+ * @return Value closest to given one in the interval
+ */
+static double clamp(const double value, const double min, const double max) {
+    return (value < min) ? min : ((value > max) ? max : value);
+}
+
+
+Cluster::Cluster(
+    const Perturbator &perturbator,
+    const unsigned int clusters,
+    const double spread) :
+    perturbator(perturbator), clusters(clusters), spread(spread) {
+}
+
+
+Cluster::~Cluster() {
+}
+
+
+/**
+ * Nodes falling outside the panel are moved to its border.
+ */
+void
+Cluster::generate(
+    const Panel panel,
+    const size_t nHoles,
+    NodeSet *nodes) const {
+    const double max_x = panel.getWidth(),
+                 max_y = panel.getHeight(),
+                 sigma = spread * ((max_x < max_y) ? max_x : max_y);
+    const unsigned int k = (clusters > 0) ? clusters : 1;
+    vector<double> c_x(k), c_y(k);
+    const size_t first = nodes->getSize();
+    nodes->reserve(first + nHoles);
+    RNG rng;
+
+    // Places centres of the clusters
+    for (unsigned int i = 0; i < k; i++) {
+        c_x[i] = rng.uniform(0.0, max_x);
+        c_y[i] = rng.uniform(0.0, max_y);
+    }
+
+    // Draws every node around a random centre
+    for (size_t i = 0; i < nHoles; i++) {
+        const unsigned int c = static_cast<unsigned int>(rng.uniform(0.0, k))
+                             % k;
+        const double x = rng.normal(c_x[c], sigma),
+                     y = rng.normal(c_y[c], sigma);
+        nodes->add(clamp(x, 0.0, max_x), clamp(y, 0.0, max_y));
+    }
+
+    perturbator(nodes, panel, first);
+}
+
+}  // namespace generator
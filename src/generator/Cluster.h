@@ -0,0 +1,81 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GENERATOR_CLUSTER_H_
+#define GENERATOR_CLUSTER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "Generator.h"
+#include "../perturbator/Perturbator.h"
+
+using perturbator::Perturbator;
+
+namespace generator {
+
+/**
+ * Generates a list of nodes.
+ * Nodes come in dense clusters, as holes of connector footprints do:
+ * centres of the clusters are uniformly distributed on the panel, and
+ * every node is drawn from a normal distribution around a random centre
+ * (a Gaussian mixture with equal weights).
+ * Nodes are guaranteed to be generated inside given panel.
+ *
+ * This class follows the Strategy Design Pattern.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class Cluster: public Generator {
+ public:
+    /**
+     * Constructor.
+     * @param[in] perturbator Perturbator to use
+     * @param[in] clusters    Number of clusters
+     * @param[in] spread      Standard deviation of the clusters, relative
+     *                        to the shorter side of the panel
+     */
+    Cluster(
+        const Perturbator &perturbator,
+        const unsigned int clusters = 10,
+        const double spread = 0.02);
+
+
+    /**
+     * Destructor.
+     */
+    virtual ~Cluster();
+
+
+    /**
+     * Generates points on a panel, adding them to a set.
+     * Points are gathered in clusters on the panel.
+     * @param[in]      panel  Panel on which generate nodes
+     * @param[in]      nHoles Number of nodes to generate
+     * @param[in, out] nodes  Set to which add the nodes
+     */
+    virtual void
+    generate(const Panel panel, const size_t nHoles, NodeSet *nodes) const;
+
+
+ private:
+    const Perturbator &perturbator;  ///< Perturbator to use
+    const unsigned int clusters;     ///< Number of clusters
+    const double spread;             ///< Relative deviation of the clusters
+};
+
+}  // namespace generator
+
+#endif  // GENERATOR_CLUSTER_H_
@@ -25,7 +25,11 @@ Generator::~Generator() {
 
 vector<Node>
 Generator::operator()(const Panel panel, const size_t nHoles) const {
-    return generate(panel, nHoles);
+    NodeSet nodes;
+
+    nodes.reserve(nHoles);
+    generate(panel, nHoles, &nodes);
+    return nodes.getNodesAsVector();
 }
 
 }  // namespace generator
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "../Node.h"
+#include "../NodeSet.h"
 #include "../Panel.h"
 
 using std::vector;
@@ -44,6 +45,7 @@ class Generator {
 
     /**
      * Generates a list of points on a panel.
+     * Identifiers of the nodes start from 1.
      * @param[in] panel  Panel on which generate nodes
      * @param[in] nHoles Number of nodes to generate
      * @return A list of nodes on given panel
@@ -52,13 +54,16 @@ class Generator {
 
 
     /**
-     * Generates a list of points on a panel.
-     * @param[in] panel  Panel on which generate nodes
-     * @param[in] nHoles Number of nodes to generate
-     * @return A list of nodes on given panel
+     * Generates points on a panel, adding them to a set.
+     * Identifiers are allocated by the set, after the ones of the nodes
+     * already in it, which are left untouched.
+     * @param[in]      panel  Panel on which generate nodes
+     * @param[in]      nHoles Number of nodes to generate
+     * @param[in, out] nodes  Set to which add the nodes
      */
-    virtual vector<Node>
-    generate(const Panel panel, const size_t nHoles) const = 0;
+    virtual void
+    generate(const Panel panel, const size_t nHoles, NodeSet *nodes) const
+        = 0;
 };
 
 }  // namespace generator
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "Grid.h"
+#include "../NodeSet.h"
+#include "../RNG.h"
+
+namespace generator {
+
+Grid::Grid(const Perturbator &perturbator, const double missing):
+    perturbator(perturbator), missing(missing) {
+}
+
+
+Grid::~Grid() {
+}
+
+
+/**
+ * Columns and rows follow the aspect ratio of the panel. Occupied cells
+ * are chosen by a partial Fisher-Yates shuffle, then visited in row major
+ * order.
+ */
+void
+Grid::generate(
+    const Panel panel,
+    const size_t nHoles,
+    NodeSet *nodes) const {
+    const double max_x  = panel.getWidth(),
+                 max_y  = panel.getHeight(),
+                 filled = (missing >= 0.0 && missing < 1.0)
+                        ? 1.0 - missing
+                        : 1.0;
+    const size_t wanted = static_cast<size_t>(ceil(nHoles / filled)),
+                 cols   = static_cast<size_t>(
+                              ceil(sqrt(wanted * max_x / max_y))),
+                 rows   = (cols > 0) ? (wanted + cols - 1) / cols : 0,
+                 cells  = rows * cols;
+    vector<size_t> cell(cells);
+    const size_t first = nodes->getSize();
+    nodes->reserve(first + nHoles);
+    RNG rng;
+
+    // Chooses occupied cells
+    for (size_t i = 0; i < cells; i++) {
+        cell[i] = i;
+    }
+    for (size_t i = 0; i < nHoles; i++) {
+        const size_t j = i + static_cast<size_t>(rng.uniform(0.0, cells - i))
+                       % (cells - i);
+        std::swap(cell[i], cell[j]);
+    }
+    std::sort(cell.begin(), cell.begin() + nHoles);
+
+    // Places nodes at the centres of the cells
+    for (size_t i = 0; i < nHoles; i++) {
+        const double x = (cell[i] % cols + 0.5) * max_x / cols,
+                     y = (cell[i] / cols + 0.5) * max_y / rows;
+        nodes->add(x, y);
+    }
+
+    perturbator(nodes, panel, first);
+}
+
+}  // namespace generator
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GENERATOR_GRID_H_
+#define GENERATOR_GRID_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "Generator.h"
+#include "../perturbator/Perturbator.h"
+
+using perturbator::Perturbator;
+
+namespace generator {
+
+/**
+ * Generates a list of nodes.
+ * Nodes lie on a rectilinear grid covering the panel, with square cells
+ * as far as the panel allows. Some cells are left empty at random: the
+ * grid has enough cells for the given fraction of them to be missing.
+ * Nodes are guaranteed to be generated inside given panel.
+ *
+ * This class follows the Strategy Design Pattern.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class Grid: public Generator {
+ public:
+    /**
+     * Constructor.
+     * @param[in] perturbator Perturbator to use
+     * @param[in] missing     Fraction of empty cells, from 0 to 1
+     */
+    explicit Grid(const Perturbator &perturbator, const double missing = 0.2);
+
+
+    /**
+     * Destructor.
+     */
+    virtual ~Grid();
+
+
+    /**
+     * Generates points on a panel, adding them to a set.
+     * Points are placed at the centres of random cells of a grid.
+     * @param[in]      panel  Panel on which generate nodes
+     * @param[in]      nHoles Number of nodes to generate
+     * @param[in, out] nodes  Set to which add the nodes
+     */
+    virtual void
+    generate(const Panel panel, const size_t nHoles, NodeSet *nodes) const;
+
+
+ private:
+    const Perturbator &perturbator;  ///< Perturbator to use
+    const double missing;            ///< Fraction of empty cells
+};
+
+}  // namespace generator
+
+#endif  // GENERATOR_GRID_H_
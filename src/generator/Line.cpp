@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "Line.h"
+#include "../NodeSet.h"
 #include "../RNG.h"
 
 namespace generator {
@@ -37,21 +38,25 @@ Line::~Line() {
  * The algorithm itselfs guarantees generated node to be on the panel: it is
  * never the case that a node is generated outside the panel.
  */
-vector<Node>
-Line::generate(const Panel panel, const size_t nHoles) const {
+void
+Line::generate(
+    const Panel panel,
+    const size_t nHoles,
+    NodeSet *nodes) const {
     const double max_x = panel.getWidth(),
                  max_y = panel.getHeight(),
                  m     = max_y / max_x;
-    vector<Node> nodes;
+    const size_t first = nodes->getSize();
+    nodes->reserve(first + nHoles);
     RNG rng;
 
     for (unsigned int i = 0; i < nHoles; i++) {
         const double x = rng.uniform(0.0, max_x),
                      y = m * x;
-        nodes.push_back(Node(x, y));
+        nodes->add(x, y);
     }
 
-    return perturbator(nodes, panel);
+    perturbator(nodes, panel, first);
 }
 
 }  // namespace generator
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <math.h>
+
+#include <vector>
+
+#include "Mixed.h"
+
+namespace generator {
+
+Mixed::Mixed(
+    const Generator &first,
+    const Generator &second,
+    const double ratio) :
+    first(first), second(second), ratio(ratio) {
+}
+
+
+Mixed::~Mixed() {
+}
+
+
+void
+Mixed::generate(
+    const Panel panel,
+    const size_t nHoles,
+    NodeSet *nodes) const {
+    const double share = (ratio < 0.0) ? 0.0 : ((ratio > 1.0) ? 1.0 : ratio);
+    const size_t n = static_cast<size_t>(floor(share * nHoles + 0.5));
+    first.generate(panel, n, nodes);
+    second.generate(panel, nHoles - n, nodes);
+}
+
+}  // namespace generator
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GENERATOR_MIXED_H_
+#define GENERATOR_MIXED_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "Generator.h"
+
+namespace generator {
+
+/**
+ * Generates a list of nodes.
+ * Nodes are generated in part by a generator and in part by another one,
+ * e.g. clusters of holes next to regular grids, as on real boards.
+ * Nodes are guaranteed to be generated inside given panel, as long as
+ * both generators guarantee it.
+ *
+ * This class follows the Strategy Design Pattern.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class Mixed: public Generator {
+ public:
+    /**
+     * Constructor.
+     * @param[in] first  Generator of the first part of the nodes
+     * @param[in] second Generator of the remaining nodes
+     * @param[in] ratio  Fraction of nodes made by first generator
+     */
+    Mixed(
+        const Generator &first,
+        const Generator &second,
+        const double ratio = 0.5);
+
+
+    /**
+     * Destructor.
+     */
+    virtual ~Mixed();
+
+
+    /**
+     * Generates points on a panel, adding them to a set.
+     * Points of the first generator come before the others.
+     * @param[in]      panel  Panel on which generate nodes
+     * @param[in]      nHoles Number of nodes to generate
+     * @param[in, out] nodes  Set to which add the nodes
+     */
+    virtual void
+    generate(const Panel panel, const size_t nHoles, NodeSet *nodes) const;
+
+
+ private:
+    const Generator &first;   ///< Generator of the first part of the nodes
+    const Generator &second;  ///< Generator of the remaining nodes
+    const double ratio;       ///< Fraction of nodes made by first generator
+};
+
+}  // namespace generator
+
+#endif  // GENERATOR_MIXED_H_
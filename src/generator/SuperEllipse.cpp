@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "SuperEllipse.h"
+#include "../NodeSet.h"
 
 #define PI 3.1415926535897
 
@@ -56,14 +57,18 @@ SuperEllipse::~SuperEllipse() {
  * A <= panel.width / 2
  * B <= panel.height / 2
  */
-vector<Node>
-SuperEllipse::generate(const Panel panel, const size_t nHoles) const {
+void
+SuperEllipse::generate(
+    const Panel panel,
+    const size_t nHoles,
+    NodeSet *nodes) const {
     const double angle = 2.0 * PI / nHoles,
                  A     = panel.getWidth() * 0.5,
                  B     = panel.getHeight() * 0.5,
                  c_x   = A,
                  c_y   = B;
-    vector<Node> nodes;
+    const size_t first = nodes->getSize();
+    nodes->reserve(first + nHoles);
 
     for (unsigned int i = 0; i < nHoles; i++) {
         const double theta = angle * i,
@@ -71,10 +76,10 @@ SuperEllipse::generate(const Panel panel, const size_t nHoles) const {
                      s     = sin(theta),
                      x     = A * pow(abs(c), 2.0 / m) * sign(c) + c_x,
                      y     = B * pow(abs(s), 2.0 / n) * sign(s) + c_y;
-        nodes.push_back(Node(x, y));
+        nodes->add(x, y);
     }
 
-    return perturbator(nodes, panel);
+    perturbator(nodes, panel, first);
 }
 
 }  // namespace generator
@@ -59,14 +59,14 @@ class SuperEllipse: public Generator {
 
 
     /**
-     * Generates a list of points on a panel.
+     * Generates points on a panel, adding them to a set.
      * Points are placed along a superellipse in the panel.
-     * @param[in] panel  Panel on which generate nodes
-     * @param[in] nHoles Number of nodes to generate
-     * @return A list of nodes on given panel
+     * @param[in]      panel  Panel on which generate nodes
+     * @param[in]      nHoles Number of nodes to generate
+     * @param[in, out] nodes  Set to which add the nodes
      */
-    virtual vector<Node>
-    generate(const Panel panel, const size_t nHoles) const;
+    virtual void
+    generate(const Panel panel, const size_t nHoles, NodeSet *nodes) const;
 
 
  private:
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "Uniform.h"
+#include "../NodeSet.h"
 #include "../RNG.h"
 
 namespace generator {
@@ -33,20 +34,24 @@ Uniform::~Uniform() {
 }
 
 
-vector<Node>
-Uniform::generate(const Panel panel, const size_t nHoles) const {
+void
+Uniform::generate(
+    const Panel panel,
+    const size_t nHoles,
+    NodeSet *nodes) const {
     const double max_x = panel.getWidth(),
                  max_y = panel.getHeight();
-    vector<Node> nodes;
-    nodes.reserve(nHoles);
+    const size_t first = nodes->getSize();
+    nodes->reserve(first + nHoles);
     RNG rng;
 
     for (size_t i = 0; i < nHoles; i++) {
-        Node new_node(rng.uniform(0.0, max_x), rng.uniform(0.0, max_y));
-        nodes.push_back(new_node);
+        const double x = rng.uniform(0.0, max_x),
+                     y = rng.uniform(0.0, max_y);
+        nodes->add(x, y);
     }
 
-    return perturbator(nodes, panel);
+    perturbator(nodes, panel, first);
 }
 
 }  // namespace generator
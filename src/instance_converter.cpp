@@ -0,0 +1,106 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <iostream>
+
+#include "Instance.h"
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * Prints the helper.
+ * @param[in] argc ARGument Counter
+ * @param[in] argv ARGument Vector
+ */
+static void show_helper(int argc, char *argv[]) {
+    (void) argc;
+    cout << "INSTANCE CONVERTER\n"
+         << "Converts an instance of the TSP problem between text and "
+         << "binary formats.\n"
+         << "Instance is read from standard input (either format is "
+         << "recognized), converted instance is written to standard "
+         << "output.\n"
+         << endl
+         << "Usage:\n"
+         << "  " << argv[0] << " -f <file> -b -t -h\n"
+         << endl
+         << "Options:\n"
+         << "  -f <file> \t Reads instance from file instead of standard\n"
+         << "            \t input (binary instances are memory-mapped)\n"
+         << "  -b        \t Writes instance in binary format (default)\n"
+         << "  -t        \t Writes instance in text format\n"
+         << "  -h        \t Prints this help and exits\n"
+         << endl
+         << "Environment:\n"
+         << "  MEMOC_THREADS \t Number of threads (default: number of\n"
+         << "                \t online processors)\n";
+}
+
+
+
+/**
+ * Converts an instance.
+ * @param[in] argc ARGument Counter
+ * @param[in] argv ARGument Vector
+ * @return EXIT_SUCCESS in case of success
+ */
+int main(int argc, char *argv[]) {
+    int opt;
+    const char *path = NULL;
+    bool binary = true;
+
+    /*******************************************************************
+     * Command line options parsing.
+     ******************************************************************/
+    while ((opt = getopt(argc, argv, "f:bth")) != -1) {
+        switch (opt) {
+        case 'f': path   = optarg; break;
+        case 'b': binary = true;   break;
+        case 't': binary = false;  break;
+        case 'h':
+            show_helper(argc, argv);
+            exit(EXIT_SUCCESS);
+
+        default:  // '?'
+            cout << "Unrecognized option. Run with -h to see the helper.\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+
+
+
+    /*******************************************************************
+     * Runs the converter.
+     ******************************************************************/
+    Instance instance = (path != NULL)
+                      ? Instance::open(path)
+                      : Instance::load(&std::cin);
+
+    if (binary) {
+        instance.saveBinary(&std::cout);
+    } else {
+        instance.save(&std::cout);
+    }
+
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdint.h>
+
+#include <iostream>
+
+#include "Stopwatch.h"
+#include "RNG.h"
+#include "Instance.h"
+#include "Solution.h"
+#include "solver/LinKernighan.h"
+
+using std::cin;
+using std::cout;
+using std::endl;
+
+
+/**
+ * Prints the helper.
+ * @param[in] argc ARGument Counter
+ * @param[in] argv ARGument Vector
+ */
+static void show_helper(int argc, char *argv[]) {
+    (void) argc;
+    cout << "LIN-KERNIGHAN SOLVER\n"
+         << "Solves and instance of the TSP problem by applying an iterated "
+         << "variable-depth local search.\n"
+         << "Instance is read form standard input, solution is written to "
+         << "standard output.\n"
+         << endl
+         << "Usage:\n"
+         << "  " << argv[0] << " -T <double> -l <int> -o <int> -e <type> "
+         << "-s <type> -k <int> -r <int> -f <file> -h" << endl
+         << endl
+         << "Options:\n"
+         << "  -T <double> \t Maximum execution time, in secs (default 5.0)\n"
+         << "  -l <int>    \t Longest chain of moves (default: 10)\n"
+         << "  -o <int>    \t Longest portion, up to 3, relocated by Or-opt,\n"
+         << "              \t 0 disables it (default: 3)\n"
+         << "  -e <type>   \t Type of the stored costs: double, float or\n"
+         << "              \t int, scaled 32 bits integers (default: double)\n"
+         << "  -s <type>   \t Storage of the costs: dense, sparse, for\n"
+         << "              \t instances missing most arcs, or triangular,\n"
+         << "              \t for symmetric ones; sparse costs are always\n"
+         << "              \t doubles, other types make triangular costs\n"
+         << "              \t dense (default: as loaded)\n"
+         << "  -k <int>    \t Candidate neighbours per node used by the\n"
+         << "              \t heuristics and the local search; 0 disables\n"
+         << "              \t chains of moves (default: 10)\n"
+         << "  -r <int>    \t Seed of the random numbers (default: depends\n"
+         << "              \t on time and process)\n"
+         << "  -f <file>   \t Reads instance from file instead of standard\n"
+         << "              \t input (binary instances are memory-mapped,\n"
+         << "              \t those saving a cost function are lazy)\n"
+         << "  -h          \t Prints this help and exits\n"
+         << endl
+         << "Environment:\n"
+         << "  MEMOC_THREADS \t Number of threads (default: number of\n"
+         << "                \t online processors)\n";
+}
+
+
+
+/**
+ * Generates and solves instances.
+ * @param[in] argc ARGument Counter
+ * @param[in] argv ARGument Vector
+ * @return EXIT_SUCCESS in case of success
+ */
+int main(int argc, char *argv[]) {
+    int opt;
+    double max_time         = 5.0;
+    unsigned int depth      = 10,
+                 or_opt     = 3,
+                 candidates = 10;
+    const char *path        = NULL;
+    bool seeded             = false;
+    uint64_t seed           = 0;
+    Instance::Precision precision = Instance::DOUBLE;
+    Instance::Storage storage     = Instance::DENSE;
+    bool converted                = false;
+
+    /*******************************************************************
+     * Command line options parsing.
+     ******************************************************************/
+    while ((opt = getopt(argc, argv, "T:l:o:e:s:k:r:f:h")) != -1) {
+        switch (opt) {
+        case 'T': max_time   = atof(optarg); break;
+        case 'l': depth      = atoi(optarg); break;
+        case 'o': or_opt     = atoi(optarg); break;
+        case 'k': candidates = atoi(optarg); break;
+        case 'r': seed = strtoull(optarg, NULL, 10); seeded = true; break;
+        case 'f': path       = optarg;       break;
+        case 'e':
+            if (strcmp(optarg, "double") == 0) {
+                precision = Instance::DOUBLE;
+            } else if (strcmp(optarg, "float") == 0) {
+                precision = Instance::FLOAT;
+            } else if (strcmp(optarg, "int") == 0) {
+                precision = Instance::FIXED;
+            } else {
+                cout << "Unrecognized type of costs: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 's':
+            converted = true;
+            if (strcmp(optarg, "dense") == 0) {
+                storage = Instance::DENSE;
+            } else if (strcmp(optarg, "sparse") == 0) {
+                storage = Instance::SPARSE;
+            } else if (strcmp(optarg, "triangular") == 0) {
+                storage = Instance::TRIANGULAR;
+            } else {
+                cout << "Unrecognized storage of costs: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'h':
+            show_helper(argc, argv);
+            exit(EXIT_SUCCESS);
+
+        default:  // '?'
+            cout << "Unrecognized option. Run with -h to see the helper.\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+
+
+
+    /*******************************************************************
+     * Runs the solver.
+     ******************************************************************/
+    if (seeded) {
+        RNG::setMasterSeed(seed);
+    }
+
+    Stopwatch sw;
+    Instance instance = (path != NULL)
+                      ? Instance::open(path)
+                      : Instance::load(&std::cin);
+    if (converted) {
+        instance.setStorage(storage);
+    }
+    instance.setPrecision(precision);
+    instance.buildCandidates(candidates);
+    solver::LinKernighan solver(max_time, depth, or_opt);
+
+    sw.start();
+    Solution solution = solver(instance);
+    sw.stop();
+
+    solution.save(&std::cout);
+    std::cout << "Cost: "      << solution.getCost()
+              << " UserTime: " << sw.getUserTime()
+              << " CPUTime: "  << sw.getCPUTime()
+              << std::endl;
+
+
+    return EXIT_SUCCESS;
+}
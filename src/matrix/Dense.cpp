@@ -0,0 +1,187 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/mman.h>
+
+#include <vector>
+
+#include "Dense.h"
+#include "../costFunction/CostFunction.h"
+
+using std::vector;
+using costFunction::CostFunction;
+
+/**
+ * Prints an error when malloc cannot allocate memory.
+ */
+#define MALLOC_ERROR \
+  fprintf(stderr, "[%s: %d]: Cannot allocate memory.\n", __FILE__, __LINE__)
+
+
+/**
+ * Performs a memory allocation and checks for the result.
+ */
+#define SAFE_MALLOC(var, type, size)              \
+    (var) = reinterpret_cast<type>(malloc(size)); \
+    if (NULL == (var)) {                          \
+        MALLOC_ERROR;                             \
+    }
+
+
+namespace matrix {
+
+template <typename T>
+Dense<T>::Dense(
+    const size_t size,
+    T *costs,
+    const double scale,
+    void *mapping,
+    const size_t mapping_size):
+    Matrix(size), costs(costs), scale(scale),
+    mapping(mapping), mapping_size(mapping_size) {
+}
+
+
+template <typename T>
+Dense<T>::Dense(const Matrix &other, const double scale):
+    Matrix(other.getSize()), scale(scale), mapping(NULL), mapping_size(0) {
+    vector<double> row(size);
+
+    SAFE_MALLOC(costs, T *, size * size * sizeof(T));
+    for (size_t i = 0; i < size; i++) {
+        other.getRow(i, &row[0]);
+        for (size_t j = 0; j < size; j++) {
+            costs[i * size + j] = encode(row[j], scale);
+        }
+    }
+}
+
+
+template <typename T>
+Dense<T>::Dense(const Dense &other):
+    Matrix(other.size), scale(other.scale), mapping(NULL), mapping_size(0) {
+    SAFE_MALLOC(costs, T *, size * size * sizeof(T));
+    memcpy(costs, other.costs, size * size * sizeof(T));
+}
+
+
+template <typename T>
+Dense<T>::~Dense() {
+    if (mapping != NULL) {
+        munmap(mapping, mapping_size);
+    } else {
+        free(costs);
+    }
+
+    costs = NULL;
+}
+
+
+template <typename T>
+Matrix *
+Dense<T>::clone() const {
+    return new Dense(*this);
+}
+
+
+template <typename T>
+double
+Dense<T>::get(const size_t i, const size_t j) const {
+    return decode(costs[i * size + j], scale);
+}
+
+
+template <typename T>
+void
+Dense<T>::getRow(const size_t i, double *row) const {
+    const T *source = costs + i * size;
+
+    for (size_t j = 0; j < size; j++) {
+        row[j] = decode(source[j], scale);
+    }
+}
+
+
+/**
+ * Rows of doubles are copied as they are.
+ */
+template <>
+void
+Dense<double>::getRow(const size_t i, double *row) const {
+    memcpy(row, costs + i * size, size * sizeof(double));
+}
+
+
+template <typename T>
+const double *
+Dense<T>::getData() const {
+    return NULL;
+}
+
+
+template <>
+const double *
+Dense<double>::getData() const {
+    return costs;
+}
+
+
+template <typename T>
+const T *
+Dense<T>::getBlock() const {
+    return costs;
+}
+
+
+template <typename T>
+double
+Dense<T>::getScale() const {
+    return scale;
+}
+
+
+template <typename T>
+T
+Dense<T>::encode(const double cost, const double scale) {
+    return (cost < 0.0) ? static_cast<T>(-1) : static_cast<T>(cost * scale);
+}
+
+
+/**
+ * Integer elements are rounded to the nearest value.
+ */
+template <>
+int32_t
+Dense<int32_t>::encode(const double cost, const double scale) {
+    return (cost < 0.0) ? -1 : static_cast<int32_t>(floor(cost * scale + 0.5));
+}
+
+
+template <typename T>
+double
+Dense<T>::decode(const T value, const double scale) {
+    return (value < 0) ? CostFunction::infinite : value / scale;
+}
+
+
+template class Dense<double>;
+template class Dense<float>;
+template class Dense<int32_t>;
+
+}  // namespace matrix
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MATRIX_DENSE_H_
+#define MATRIX_DENSE_H_
+
+#include <stdint.h>
+
+#include <cstddef>
+
+#include "Matrix.h"
+
+namespace matrix {
+
+/**
+ * Stores every cost in a contiguous block, row major.
+ * Block may be allocated with malloc or be part of a memory-mapped file.
+ *
+ * Costs are stored as elements of type T: double, float or int32_t are
+ * supported. Costs are multiplied by a scale factor before being stored
+ * (and divided by it when read), so that integer elements keep a fixed
+ * number of fractional bits. Missing arcs are stored as negative values.
+ * Narrower elements halve memory and bandwidth of algorithms scanning
+ * the block directly.
+ *
+ * This class follows the Strategy Design Pattern.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+template <typename T>
+class Dense: public Matrix {
+ public:
+    /**
+     * Constructor.
+     * Matrix takes ownership of the block of costs: it is released with
+     * free or, when a mapping is given, by unmapping the whole mapping.
+     * @param[in] size         Number of nodes
+     * @param[in] costs        Costs, size x size and row major
+     * @param[in] scale        Scale factor of the stored costs
+     * @param[in] mapping      Memory-mapped file containing costs, if any
+     * @param[in] mapping_size Size of the memory-mapped file
+     */
+    Dense(
+        const size_t size,
+        T *costs,
+        const double scale = 1.0,
+        void *mapping = NULL,
+        const size_t mapping_size = 0);
+
+
+    /**
+     * Conversion constructor.
+     * Copies costs from another matrix, scaling and converting them.
+     * @param[in] other Matrix to copy from
+     * @param[in] scale Scale factor of the stored costs
+     */
+    Dense(const Matrix &other, const double scale);
+
+
+    /**
+     * Copy constructor.
+     * Copy is always allocated with malloc.
+     * @param[in] other Matrix to copy from
+     */
+    Dense(const Dense &other);
+
+
+    /**
+     * Destructor.
+     */
+    virtual ~Dense();
+
+
+    /**
+     * Returns a copy of this matrix.
+     * @return A copy of this matrix, to be deleted by the caller
+     */
+    virtual Matrix *clone() const;
+
+
+    /**
+     * Returns cost of an arc.
+     * @param[in] i Index of the source node
+     * @param[in] j Index of the target node
+     * @return Cost of the arc (i, j)
+     */
+    virtual double get(const size_t i, const size_t j) const;
+
+
+    /**
+     * Returns costs of every arc leaving a node.
+     * Row is copied from the block.
+     * @param[in]  i   Index of the source node
+     * @param[out] row Costs of the arcs, size elements
+     */
+    virtual void getRow(const size_t i, double *row) const;
+
+
+    /**
+     * Returns matrix as a contiguous block of costs.
+     * @return Costs, size x size and row major, or NULL if T is not double
+     */
+    virtual const double *getData() const;
+
+
+    /**
+     * Returns the block of stored costs.
+     * @return Stored costs, size x size and row major
+     */
+    const T *getBlock() const;
+
+
+    /**
+     * Returns the scale factor of the stored costs.
+     * @return Scale factor
+     */
+    double getScale() const;
+
+
+    /**
+     * Converts a cost into a stored element.
+     * @param[in] cost  Cost to convert
+     * @param[in] scale Scale factor
+     * @return Stored element
+     */
+    static T encode(const double cost, const double scale);
+
+
+    /**
+     * Converts a stored element into a cost.
+     * @param[in] value Stored element
+     * @param[in] scale Scale factor
+     * @return Cost
+     */
+    static double decode(const T value, const double scale);
+
+
+ private:
+    T *costs;             ///< Costs, row major
+    double scale;         ///< Scale factor of the stored costs
+    void *mapping;        ///< Memory-mapped file, if any
+    size_t mapping_size;  ///< Size of the memory-mapped file
+};
+
+}  // namespace matrix
+
+#endif  // MATRIX_DENSE_H_
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <climits>
+#include <limits>
+
+#include "Lazy.h"
+#include "../Parallel.h"
+
+/**
+ * Prints an error when malloc cannot allocate memory.
+ */
+#define MALLOC_ERROR \
+  fprintf(stderr, "[%s: %d]: Cannot allocate memory.\n", __FILE__, __LINE__)
+
+
+/**
+ * Performs a memory allocation and checks for the result.
+ */
+#define SAFE_MALLOC(var, type, size)              \
+    (var) = reinterpret_cast<type>(malloc(size)); \
+    if (NULL == (var)) {                          \
+        MALLOC_ERROR;                             \
+    }
+
+
+/** Number of rows in a tile. */
+static const size_t ROWS_PER_TILE = 16;
+
+/** Marks a tile which is not in the cache. */
+static const unsigned int NO_SLOT = UINT_MAX;
+
+/** Most arcs cached by a thread, a power of two. */
+static const size_t MAX_ARCS = 1 << 16;
+
+/** Marks a slot of the arcs cache which holds no arc. */
+static const uint64_t NO_ARC = std::numeric_limits<uint64_t>::max();
+
+
+namespace matrix {
+
+Lazy::Lazy(
+    const vector<Node> &nodes,
+    const costFunction::Coordinates &targets,
+    const costFunction::CostFunction &cost,
+    const size_t budget):
+    Matrix(nodes.size()), nodes(nodes), targets(targets), cost(cost),
+    budget(budget) {
+    allocate();
+}
+
+
+Lazy::Lazy(const Lazy &other):
+    Matrix(other.size), nodes(other.nodes), targets(other.targets),
+    cost(other.cost), budget(other.budget) {
+    allocate();
+}
+
+
+Lazy::~Lazy() {
+    pthread_key_delete(key);
+    pthread_mutex_destroy(&mutex);
+    for (size_t c = 0; c < caches.size(); c++) {
+        free(caches[c]->tiles);
+        delete caches[c];
+    }
+    caches.clear();
+}
+
+
+Matrix *
+Lazy::clone() const {
+    return new Lazy(*this);
+}
+
+
+/**
+ * Reads the cache of the calling thread only, without any lock. Costs
+ * out of cached tiles are kept in a direct-mapped cache of arcs, indexed
+ * by a multiplicative hash of the arc.
+ */
+double
+Lazy::get(const size_t i, const size_t j) const {
+    Cache *cache = local();
+    const unsigned int slot = cache->slot_of[i / ROWS_PER_TILE];
+
+    if (slot != NO_SLOT) {
+        cache->last_use[slot] = ++cache->clock;
+        return cache->tiles[
+            (slot * ROWS_PER_TILE + i % ROWS_PER_TILE) * size + j];
+    }
+
+    const uint64_t arc  = static_cast<uint64_t>(i) * size + j;
+    Arc &entry = cache->arcs[
+        (arc * 0x9E3779B97F4A7C15ULL >> 32) & (cache->arcs.size() - 1)];
+    if (entry.arc != arc) {
+        entry.arc  = arc;
+        entry.cost = cost(nodes[i], nodes[j]);
+    }
+
+    return entry.cost;
+}
+
+
+/**
+ * Tiles are loaded by sequential scans only, from the first row of a
+ * tile on, so that every row of a scan is computed once; rows read out
+ * of order are computed straight into the buffer.
+ */
+void
+Lazy::getRow(const size_t i, double *row) const {
+    Cache *cache = local();
+    const size_t tile = i / ROWS_PER_TILE;
+    const bool sequential = (i == cache->next_row);
+
+    cache->next_row = i + 1;
+    if (cache->slot_of[tile] == NO_SLOT
+        && !(sequential && i % ROWS_PER_TILE == 0)) {
+        cost.row(nodes[i], targets, row);
+        return;
+    }
+
+    memcpy(row,
+           loadTile(cache, tile) + (i % ROWS_PER_TILE) * size,
+           size * sizeof(double));
+}
+
+
+const costFunction::CostFunction &
+Lazy::getCostFunction() const {
+    return cost;
+}
+
+
+size_t
+Lazy::getBudget() const {
+    return budget;
+}
+
+
+/**
+ * Mutex is taken only when a thread reads its first cost, in order to
+ * add its cache to the list of caches.
+ */
+Lazy::Cache *
+Lazy::local() const {
+    Cache *cache = reinterpret_cast<Cache *>(pthread_getspecific(key));
+
+    if (cache == NULL) {
+        const size_t tiles = (size + ROWS_PER_TILE - 1) / ROWS_PER_TILE;
+        cache = new Cache;
+        SAFE_MALLOC(cache->tiles, double *,
+                    capacity * ROWS_PER_TILE * size * sizeof(double) + 1);
+        cache->slot_of.assign(tiles, NO_SLOT);
+        cache->tile_of.assign(capacity, tiles);
+        cache->last_use.assign(capacity, 0);
+        cache->clock = 0;
+        cache->arcs.resize(arcs);
+        for (size_t a = 0; a < arcs; a++) {
+            cache->arcs[a].arc = NO_ARC;
+        }
+        cache->next_row = 0;
+        pthread_setspecific(key, cache);
+
+        pthread_mutex_lock(&mutex);
+        caches.push_back(cache);
+        pthread_mutex_unlock(&mutex);
+    }
+
+    return cache;
+}
+
+
+/**
+ * Least recently used slot is found by a linear scan, which is cheap
+ * with respect to computing a tile.
+ */
+const double *
+Lazy::loadTile(Cache *cache, const size_t tile) const {
+    unsigned int slot = cache->slot_of[tile];
+
+    if (slot == NO_SLOT) {
+        // Evicts least recently used tile
+        slot = 0;
+        for (unsigned int s = 1; s < capacity; s++) {
+            if (cache->last_use[s] < cache->last_use[slot]) {
+                slot = s;
+            }
+        }
+        if (cache->tile_of[slot] < cache->slot_of.size()) {
+            cache->slot_of[cache->tile_of[slot]] = NO_SLOT;
+        }
+
+        // Computes rows of the tile
+        const size_t first = tile * ROWS_PER_TILE,
+                     last  = (first + ROWS_PER_TILE < size)
+                           ? first + ROWS_PER_TILE : size;
+        double *costs = cache->tiles + slot * ROWS_PER_TILE * size;
+        for (size_t i = first; i < last; i++) {
+            cost.row(nodes[i], targets, costs + (i - first) * size);
+        }
+
+        cache->slot_of[tile] = slot;
+        cache->tile_of[slot] = tile;
+    }
+
+    cache->last_use[slot] = ++cache->clock;
+    return cache->tiles + slot * ROWS_PER_TILE * size;
+}
+
+
+/**
+ * Arcs take at most a quarter of the share of every thread, tiles take
+ * the rest.
+ */
+void
+Lazy::allocate() {
+    const size_t tiles      = (size + ROWS_PER_TILE - 1) / ROWS_PER_TILE,
+                 tile_bytes = ROWS_PER_TILE * size * sizeof(double),
+                 share      = budget / Parallel::getThreads();
+
+    arcs = 1;
+    while (arcs < MAX_ARCS && 2 * arcs * sizeof(Arc) <= share / 4) {
+        arcs *= 2;
+    }
+    const size_t rest = share - ((arcs * sizeof(Arc) < share)
+                                 ? arcs * sizeof(Arc) : share);
+    capacity = (tile_bytes > 0) ? rest / tile_bytes : 0;
+    capacity = (capacity > tiles) ? tiles : capacity;
+    capacity = (capacity < 1) ? 1 : capacity;
+
+    pthread_key_create(&key, NULL);
+    pthread_mutex_init(&mutex, NULL);
+}
+
+}  // namespace matrix
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MATRIX_LAZY_H_
+#define MATRIX_LAZY_H_
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "Matrix.h"
+#include "../Node.h"
+#include "../costFunction/CostFunction.h"
+
+using std::vector;
+
+namespace matrix {
+
+/**
+ * Computes costs on demand.
+ * Costs are computed by a cost function from the nodes when they are
+ * requested. Rows read in sequence are computed in tiles of consecutive
+ * rows, which are kept in a cache within a memory budget; least recently
+ * used tiles are evicted first. Rows read out of sequence are computed
+ * alone, unless their tile is in the cache. Single costs are read from
+ * the cache when their tile is in it, otherwise from a smaller cache of
+ * arcs, in which arcs overwrite each other.
+ * Memory is bounded by the budget, so that instances whose matrix does
+ * not fit in memory can still be used.
+ *
+ * Every thread has a cache of its own, created the first time it reads
+ * a cost, so that costs are read by several threads at once without
+ * locking; the budget is shared evenly among Parallel::getThreads()
+ * caches. Caches are released with the matrix.
+ *
+ * Nodes are not copied: they, and the cost function, must outlive the
+ * matrix. Cost function must return the same cost every time it is
+ * evaluated on the same arc.
+ *
+ * This class follows the Strategy Design Pattern.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class Lazy: public Matrix {
+ public:
+    /**
+     * Constructor.
+     * Every cache holds at least one tile and one arc, whatever the
+     * budget.
+     * @param[in] nodes   Nodes, by dense index
+     * @param[in] targets Nodes, as contiguous arrays, by dense index
+     * @param[in] cost    Function telling costs among nodes
+     * @param[in] budget  Memory for the caches, in bytes
+     */
+    Lazy(
+        const vector<Node> &nodes,
+        const costFunction::Coordinates &targets,
+        const costFunction::CostFunction &cost,
+        const size_t budget);
+
+
+    /**
+     * Copy constructor.
+     * Copy shares nodes and cost function of the other matrix, and
+     * starts with empty caches.
+     * @param[in] other Matrix to copy from
+     */
+    Lazy(const Lazy &other);
+
+
+    /**
+     * Destructor.
+     */
+    virtual ~Lazy();
+
+
+    /**
+     * Returns a copy of this matrix.
+     * @return A copy of this matrix, to be deleted by the caller
+     */
+    virtual Matrix *clone() const;
+
+
+    /**
+     * Returns cost of an arc.
+     * @param[in] i Index of the source node
+     * @param[in] j Index of the target node
+     * @return Cost of the arc (i, j)
+     */
+    virtual double get(const size_t i, const size_t j) const;
+
+
+    /**
+     * Returns costs of every arc leaving a node.
+     * Tile containing the row is loaded into the cache of the calling
+     * thread if the row starts it and follows the last row read.
+     * @param[in]  i   Index of the source node
+     * @param[out] row Costs of the arcs, size elements
+     */
+    virtual void getRow(const size_t i, double *row) const;
+
+
+    /**
+     * Returns the cost function.
+     * @return Function telling costs among nodes
+     */
+    const costFunction::CostFunction &getCostFunction() const;
+
+
+    /**
+     * Returns the memory budget.
+     * @return Memory for the caches, in bytes
+     */
+    size_t getBudget() const;
+
+
+ private:
+    /** An arc cached by a thread. */
+    struct Arc {
+        uint64_t arc;  ///< Arc, as source times size plus target
+        double cost;   ///< Cost of the arc
+    };
+
+
+    /** Tiles and arcs cached by a thread. */
+    struct Cache {
+        double *tiles;                 ///< Cached tiles
+        vector<unsigned int> slot_of;  ///< Slot of each tile
+        vector<size_t> tile_of;        ///< Tile in each slot
+        vector<uint64_t> last_use;     ///< Last use of each slot
+        uint64_t clock;                ///< Number of uses so far
+        vector<Arc> arcs;              ///< Arcs read out of tiles
+        size_t next_row;               ///< Row following the last read
+    };
+
+
+    /**
+     * Returns the cache of the calling thread, creating it if needed.
+     * @return Cache of the calling thread
+     */
+    Cache *local() const;
+
+
+    /**
+     * Returns a tile, loading it into a cache if needed.
+     * @param[in, out] cache Cache of the calling thread
+     * @param[in]      tile  Index of the tile
+     * @return Costs of the rows in the tile, row major
+     */
+    const double *loadTile(Cache *cache, const size_t tile) const;
+
+
+    /**
+     * Prepares an empty set of caches.
+     */
+    void allocate();
+
+
+    const vector<Node> &nodes;                ///< Nodes, by dense index
+    const costFunction::Coordinates targets;  ///< Nodes, as arrays
+    const costFunction::CostFunction &cost;   ///< Cost function
+    const size_t budget;                      ///< Memory for the caches
+    size_t capacity;                          ///< Tiles in each cache
+    size_t arcs;                              ///< Arcs in each cache
+    pthread_key_t key;                        ///< Cache of each thread
+    mutable vector<Cache *> caches;           ///< Caches of every thread
+    mutable pthread_mutex_t mutex;            ///< Guards list of caches
+};
+
+}  // namespace matrix
+
+#endif  // MATRIX_LAZY_H_
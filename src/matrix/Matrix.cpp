@@ -0,0 +1,93 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+
+#include "Matrix.h"
+
+using std::vector;
+
+namespace matrix {
+
+Matrix::Matrix(const size_t size):
+    size(size) {
+}
+
+
+Matrix::~Matrix() {
+}
+
+
+size_t
+Matrix::getSize() const {
+    return size;
+}
+
+
+void
+Matrix::getRow(const size_t i, double *row) const {
+    for (size_t j = 0; j < size; j++) {
+        row[j] = get(i, j);
+    }
+}
+
+
+size_t
+Matrix::getOutArcs(
+    const size_t i,
+    unsigned int *targets,
+    double *costs) const {
+    vector<double> row(size);
+    size_t arcs = 0;
+
+    getRow(i, &row[0]);
+    for (size_t j = 0; j < size; j++) {
+        if (row[j] >= 0.0) {
+            targets[arcs] = j;
+            costs[arcs]   = row[j];
+            arcs++;
+        }
+    }
+
+    return arcs;
+}
+
+
+size_t
+Matrix::getInArcs(
+    const size_t j,
+    unsigned int *sources,
+    double *costs) const {
+    size_t arcs = 0;
+
+    for (size_t i = 0; i < size; i++) {
+        const double cost = get(i, j);
+        if (cost >= 0.0) {
+            sources[arcs] = i;
+            costs[arcs]   = cost;
+            arcs++;
+        }
+    }
+
+    return arcs;
+}
+
+
+const double *
+Matrix::getData() const {
+    return NULL;
+}
+
+}  // namespace matrix
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MATRIX_MATRIX_H_
+#define MATRIX_MATRIX_H_
+
+#include <cstddef>
+
+namespace matrix {
+
+/**
+ * Stores costs of the arcs of an instance.
+ * Arcs are addressed by dense indices of their nodes. Missing arcs have
+ * cost CostFunction::infinite (a negative value).
+ * Subclasses must implement the pure virtual member functions following
+ * the desired storage layout.
+ *
+ * This class follows the Strategy Design Pattern.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class Matrix {
+ public:
+    /**
+     * Constructor.
+     * @param[in] size Number of nodes
+     */
+    explicit Matrix(const size_t size);
+
+
+    /**
+     * Destructor.
+     */
+    virtual ~Matrix();
+
+
+    /**
+     * Returns a copy of this matrix.
+     * @return A copy of this matrix, to be deleted by the caller
+     */
+    virtual Matrix *clone() const = 0;
+
+
+    /**
+     * Returns number of nodes.
+     * @return Number of nodes
+     */
+    size_t getSize() const;
+
+
+    /**
+     * Returns cost of an arc.
+     * @param[in] i Index of the source node
+     * @param[in] j Index of the target node
+     * @return Cost of the arc (i, j)
+     */
+    virtual double get(const size_t i, const size_t j) const = 0;
+
+
+    /**
+     * Returns costs of every arc leaving a node.
+     * @param[in]  i   Index of the source node
+     * @param[out] row Costs of the arcs, size elements
+     */
+    virtual void getRow(const size_t i, double *row) const;
+
+
+    /**
+     * Returns existing arcs leaving a node.
+     * Arcs are sorted by target.
+     * @param[in]  i       Index of the source node
+     * @param[out] targets Targets of the arcs, up to size elements
+     * @param[out] costs   Costs of the arcs, up to size elements
+     * @return Number of arcs
+     */
+    virtual size_t getOutArcs(
+        const size_t i,
+        unsigned int *targets,
+        double *costs) const;
+
+
+    /**
+     * Returns existing arcs entering a node.
+     * Arcs are sorted by source.
+     * @param[in]  j       Index of the target node
+     * @param[out] sources Sources of the arcs, up to size elements
+     * @param[out] costs   Costs of the arcs, up to size elements
+     * @return Number of arcs
+     */
+    virtual size_t getInArcs(
+        const size_t j,
+        unsigned int *sources,
+        double *costs) const;
+
+
+    /**
+     * Returns matrix as a contiguous block of costs, if available.
+     * @return Costs, size x size and row major, or NULL
+     */
+    virtual const double *getData() const;
+
+
+ protected:
+    const size_t size;  ///< Number of nodes
+};
+
+}  // namespace matrix
+
+#endif  // MATRIX_MATRIX_H_
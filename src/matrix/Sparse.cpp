@@ -0,0 +1,155 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "Sparse.h"
+#include "../costFunction/CostFunction.h"
+
+using costFunction::CostFunction;
+
+namespace matrix {
+
+Sparse::Sparse(const size_t size):
+    Matrix(size), out_offsets(1, 0) {
+}
+
+
+Sparse::~Sparse() {
+}
+
+
+Sparse &
+Sparse::addRow(const double *row) {
+    for (size_t j = 0; j < size; j++) {
+        if (row[j] >= 0.0) {
+            out_targets.push_back(j);
+            out_costs.push_back(row[j]);
+        }
+    }
+    out_offsets.push_back(out_targets.size());
+
+    return *this;
+}
+
+
+/**
+ * Arcs are distributed among columns with a counting sort, which keeps
+ * them sorted by source.
+ */
+Sparse &
+Sparse::close() {
+    const size_t arcs = out_targets.size();
+
+    // Counts arcs entering each node
+    in_offsets.assign(size + 1, 0);
+    for (size_t k = 0; k < arcs; k++) {
+        in_offsets[out_targets[k] + 1]++;
+    }
+    for (size_t j = 0; j < size; j++) {
+        in_offsets[j + 1] += in_offsets[j];
+    }
+
+    // Fills columns
+    vector<size_t> cursor(in_offsets.begin(), in_offsets.end() - 1);
+    in_sources.resize(arcs);
+    in_costs.resize(arcs);
+    for (size_t i = 0; i + 1 < out_offsets.size(); i++) {
+        for (size_t k = out_offsets[i]; k < out_offsets[i + 1]; k++) {
+            const size_t position = cursor[out_targets[k]]++;
+            in_sources[position] = i;
+            in_costs[position]   = out_costs[k];
+        }
+    }
+
+    return *this;
+}
+
+
+size_t
+Sparse::getArcs() const {
+    return out_targets.size();
+}
+
+
+Matrix *
+Sparse::clone() const {
+    return new Sparse(*this);
+}
+
+
+double
+Sparse::get(const size_t i, const size_t j) const {
+    const unsigned int target = j;
+    const vector<unsigned int>::const_iterator
+        begin = out_targets.begin() + out_offsets[i],
+        end   = out_targets.begin() + out_offsets[i + 1],
+        arc   = std::lower_bound(begin, end, target);
+
+    if (arc == end || *arc != target) {
+        return CostFunction::infinite;
+    }
+
+    return out_costs[arc - out_targets.begin()];
+}
+
+
+void
+Sparse::getRow(const size_t i, double *row) const {
+    std::fill(row, row + size, CostFunction::infinite);
+
+    for (size_t k = out_offsets[i]; k < out_offsets[i + 1]; k++) {
+        row[out_targets[k]] = out_costs[k];
+    }
+}
+
+
+size_t
+Sparse::getOutArcs(
+    const size_t i,
+    unsigned int *targets,
+    double *costs) const {
+    const size_t first = out_offsets[i],
+                 arcs  = out_offsets[i + 1] - first;
+
+    if (arcs > 0) {
+        memcpy(targets, &out_targets[first], arcs * sizeof(unsigned int));
+        memcpy(costs, &out_costs[first], arcs * sizeof(double));
+    }
+
+    return arcs;
+}
+
+
+size_t
+Sparse::getInArcs(
+    const size_t j,
+    unsigned int *sources,
+    double *costs) const {
+    const size_t first = in_offsets[j],
+                 arcs  = in_offsets[j + 1] - first;
+
+    if (arcs > 0) {
+        memcpy(sources, &in_sources[first], arcs * sizeof(unsigned int));
+        memcpy(costs, &in_costs[first], arcs * sizeof(double));
+    }
+
+    return arcs;
+}
+
+}  // namespace matrix
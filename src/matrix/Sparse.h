@@ -0,0 +1,146 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MATRIX_SPARSE_H_
+#define MATRIX_SPARSE_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "Matrix.h"
+
+using std::vector;
+
+namespace matrix {
+
+/**
+ * Stores costs of existing arcs only.
+ * Arcs leaving each node are kept in compressed rows (CSR), arcs
+ * entering each node in compressed columns, so that both can be scanned
+ * in time proportional to their number. Memory is proportional to the
+ * number of existing arcs, which pays off when most arcs are missing
+ * (e.g. with a threshold on their length).
+ * Matrix is built one row at a time, then closed.
+ *
+ * This class follows the Strategy Design Pattern.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class Sparse: public Matrix {
+ public:
+    /**
+     * Constructor.
+     * Builds an empty matrix: rows must be added in order, then the
+     * matrix must be closed.
+     * @param[in] size Number of nodes
+     */
+    explicit Sparse(const size_t size);
+
+
+    /**
+     * Destructor.
+     */
+    virtual ~Sparse();
+
+
+    /**
+     * Adds next row.
+     * Only existing arcs (non negative costs) are stored.
+     * @param[in] row Costs of the arcs leaving next node, size elements
+     * @return This matrix itself
+     */
+    Sparse &addRow(const double *row);
+
+
+    /**
+     * Closes this matrix.
+     * Builds index of the arcs entering each node.
+     * @return This matrix itself
+     */
+    Sparse &close();
+
+
+    /**
+     * Returns number of existing arcs.
+     * @return Number of existing arcs
+     */
+    size_t getArcs() const;
+
+
+    /**
+     * Returns a copy of this matrix.
+     * @return A copy of this matrix, to be deleted by the caller
+     */
+    virtual Matrix *clone() const;
+
+
+    /**
+     * Returns cost of an arc.
+     * Arc is searched among arcs leaving node i.
+     * @param[in] i Index of the source node
+     * @param[in] j Index of the target node
+     * @return Cost of the arc (i, j)
+     */
+    virtual double get(const size_t i, const size_t j) const;
+
+
+    /**
+     * Returns costs of every arc leaving a node.
+     * @param[in]  i   Index of the source node
+     * @param[out] row Costs of the arcs, size elements
+     */
+    virtual void getRow(const size_t i, double *row) const;
+
+
+    /**
+     * Returns existing arcs leaving a node.
+     * Arcs are sorted by target.
+     * @param[in]  i       Index of the source node
+     * @param[out] targets Targets of the arcs, up to size elements
+     * @param[out] costs   Costs of the arcs, up to size elements
+     * @return Number of arcs
+     */
+    virtual size_t getOutArcs(
+        const size_t i,
+        unsigned int *targets,
+        double *costs) const;
+
+
+    /**
+     * Returns existing arcs entering a node.
+     * Arcs are sorted by source.
+     * @param[in]  j       Index of the target node
+     * @param[out] sources Sources of the arcs, up to size elements
+     * @param[out] costs   Costs of the arcs, up to size elements
+     * @return Number of arcs
+     */
+    virtual size_t getInArcs(
+        const size_t j,
+        unsigned int *sources,
+        double *costs) const;
+
+
+ private:
+    vector<size_t> out_offsets;        ///< First out-arc of each node
+    vector<unsigned int> out_targets;  ///< Targets of out-arcs
+    vector<double> out_costs;          ///< Costs of out-arcs
+    vector<size_t> in_offsets;         ///< First in-arc of each node
+    vector<unsigned int> in_sources;   ///< Sources of in-arcs
+    vector<double> in_costs;           ///< Costs of in-arcs
+};
+
+}  // namespace matrix
+
+#endif  // MATRIX_SPARSE_H_
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "Triangular.h"
+
+/**
+ * Prints an error when malloc cannot allocate memory.
+ */
+#define MALLOC_ERROR \
+  fprintf(stderr, "[%s: %d]: Cannot allocate memory.\n", __FILE__, __LINE__)
+
+
+/**
+ * Performs a memory allocation and checks for the result.
+ */
+#define SAFE_MALLOC(var, type, size)              \
+    (var) = reinterpret_cast<type>(malloc(size)); \
+    if (NULL == (var)) {                          \
+        MALLOC_ERROR;                             \
+    }
+
+
+namespace matrix {
+
+Triangular::Triangular(
+    const size_t size,
+    double *costs,
+    void *mapping,
+    const size_t mapping_size):
+    Matrix(size), costs(costs),
+    mapping(mapping), mapping_size(mapping_size) {
+}
+
+
+Triangular::Triangular(const Triangular &other):
+    Matrix(other.size), mapping(NULL), mapping_size(0) {
+    const size_t length = size * (size + 1) / 2 * sizeof(double);
+
+    SAFE_MALLOC(costs, double *, length);
+    memcpy(costs, other.costs, length);
+}
+
+
+Triangular::~Triangular() {
+    if (mapping != NULL) {
+        munmap(mapping, mapping_size);
+    } else {
+        free(costs);
+    }
+
+    costs = NULL;
+}
+
+
+Matrix *
+Triangular::clone() const {
+    return new Triangular(*this);
+}
+
+
+double
+Triangular::get(const size_t i, const size_t j) const {
+    return (i <= j)
+         ? costs[offset(size, i) + (j - i)]
+         : costs[offset(size, j) + (i - j)];
+}
+
+
+/**
+ * Element (j, i) of row j < i lies i - j positions after the start of
+ * row j, and rows shrink by one element each.
+ */
+void
+Triangular::getRow(const size_t i, double *row) const {
+    size_t position = i;
+
+    for (size_t j = 0; j < i; j++) {
+        row[j] = costs[position];
+        position += size - j - 1;
+    }
+
+    memcpy(row + i, costs + offset(size, i), (size - i) * sizeof(double));
+}
+
+
+size_t
+Triangular::getInArcs(
+    const size_t j,
+    unsigned int *sources,
+    double *costs) const {
+    return getOutArcs(j, sources, costs);
+}
+
+
+const double *
+Triangular::getBlock() const {
+    return costs;
+}
+
+
+size_t
+Triangular::offset(const size_t size, const size_t i) {
+    return i * (2 * size - i + 1) / 2;
+}
+
+}  // namespace matrix
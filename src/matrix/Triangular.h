@@ -0,0 +1,135 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MATRIX_TRIANGULAR_H_
+#define MATRIX_TRIANGULAR_H_
+
+#include <cstddef>
+
+#include "Matrix.h"
+
+namespace matrix {
+
+/**
+ * Stores costs of a symmetric matrix, upper triangle only.
+ * Cost of arc (i, j) is the cost of arc (j, i): elements with j >= i are
+ * stored row by row in a contiguous block of size * (size + 1) / 2
+ * doubles, which halves memory with respect to a dense matrix. Row i
+ * starts at offset(size, i). Block may be allocated with malloc or be
+ * part of a memory-mapped file.
+ *
+ * This class follows the Strategy Design Pattern.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class Triangular: public Matrix {
+ public:
+    /**
+     * Constructor.
+     * Matrix takes ownership of the block of costs: it is released with
+     * free or, when a mapping is given, by unmapping the whole mapping.
+     * @param[in] size         Number of nodes
+     * @param[in] costs        Upper triangle, row major,
+     *                         size * (size + 1) / 2 elements
+     * @param[in] mapping      Memory-mapped file containing costs, if any
+     * @param[in] mapping_size Size of the memory-mapped file
+     */
+    Triangular(
+        const size_t size,
+        double *costs,
+        void *mapping = NULL,
+        const size_t mapping_size = 0);
+
+
+    /**
+     * Copy constructor.
+     * Copy is always allocated with malloc.
+     * @param[in] other Matrix to copy from
+     */
+    Triangular(const Triangular &other);
+
+
+    /**
+     * Destructor.
+     */
+    virtual ~Triangular();
+
+
+    /**
+     * Returns a copy of this matrix.
+     * @return A copy of this matrix, to be deleted by the caller
+     */
+    virtual Matrix *clone() const;
+
+
+    /**
+     * Returns cost of an arc.
+     * @param[in] i Index of the source node
+     * @param[in] j Index of the target node
+     * @return Cost of the arc (i, j)
+     */
+    virtual double get(const size_t i, const size_t j) const;
+
+
+    /**
+     * Returns costs of every arc leaving a node.
+     * Elements before the diagonal are gathered from the column, the
+     * others are copied from the row.
+     * @param[in]  i   Index of the source node
+     * @param[out] row Costs of the arcs, size elements
+     */
+    virtual void getRow(const size_t i, double *row) const;
+
+
+    /**
+     * Returns existing arcs entering a node.
+     * Arcs entering a node are the ones leaving it.
+     * @param[in]  j       Index of the target node
+     * @param[out] sources Sources of the arcs, up to size elements
+     * @param[out] costs   Costs of the arcs, up to size elements
+     * @return Number of arcs
+     */
+    virtual size_t getInArcs(
+        const size_t j,
+        unsigned int *sources,
+        double *costs) const;
+
+
+    /**
+     * Returns the block of stored costs.
+     * @return Upper triangle, row major
+     */
+    const double *getBlock() const;
+
+
+    /**
+     * Returns position of the first stored element of a row.
+     * First stored element of row i is (i, i).
+     * @param[in] size Number of nodes
+     * @param[in] i    Index of the row
+     * @return Offset of element (i, i) in the block
+     */
+    static size_t offset(const size_t size, const size_t i);
+
+
+ private:
+    double *costs;        ///< Upper triangle, row major
+    void *mapping;        ///< Memory-mapped file, if any
+    size_t mapping_size;  ///< Size of the memory-mapped file
+};
+
+}  // namespace matrix
+
+#endif  // MATRIX_TRIANGULAR_H_
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+
+#include "Chain.h"
+
+namespace perturbator {
+
+Chain::Chain(const Perturbator &first, const Perturbator &second):
+    first(first), second(second) {
+}
+
+
+Chain::~Chain() {
+}
+
+
+void
+Chain::perturbate(
+    double *x,
+    double *y,
+    const size_t size,
+    const Panel &panel) const {
+    first.perturbate(x, y, size, panel);
+    second.perturbate(x, y, size, panel);
+}
+
+}  // namespace perturbator
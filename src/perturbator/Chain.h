@@ -0,0 +1,72 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PERTURBATOR_CHAIN_H_
+#define PERTURBATOR_CHAIN_H_
+
+#include <cstddef>
+
+#include "Perturbator.h"
+
+namespace perturbator {
+
+/**
+ * Applies two perturbations on a list of nodes, one after the other.
+ * Both perturbations move the same coordinates in place, without
+ * intermediate copies; longer chains are built by chaining chains.
+ *
+ * This class follows the Strategy Design Pattern and the Composite
+ * Design Pattern.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class Chain: public Perturbator {
+ public:
+    /**
+     * Constructor.
+     * @param[in] first  Perturbation applied first
+     * @param[in] second Perturbation applied next
+     */
+    Chain(const Perturbator &first, const Perturbator &second);
+
+
+    /**
+     * Destructor.
+     */
+    virtual ~Chain();
+
+
+    /**
+     * Perturbates a set of points on a panel, in place.
+     * @param[in,out] x     X-coordinates of the points
+     * @param[in,out] y     Y-coordinates of the points
+     * @param[in]     size  Number of points
+     * @param[in]     panel Panel on which operate
+     */
+    virtual void perturbate(
+        double *x,
+        double *y,
+        const size_t size,
+        const Panel &panel) const;
+
+
+ private:
+    const Perturbator &first;   ///< Perturbation applied first
+    const Perturbator &second;  ///< Perturbation applied next
+};
+
+}  // namespace perturbator
+
+#endif  // PERTURBATOR_CHAIN_H_
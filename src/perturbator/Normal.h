@@ -16,7 +16,7 @@
 #ifndef PERTURBATOR_NORMAL_H_
 #define PERTURBATOR_NORMAL_H_
 
-#include <vector>
+#include <cstddef>
 
 #include "Perturbator.h"
 
@@ -48,15 +48,18 @@ class Normal: public Perturbator {
 
 
     /**
-     * Perturbates a list of points on a panel.
-     * Points coordinates are perturbated, altering their coordinates
-     * up to a given magnitude (in each dimension).
-     * @param[in] nodes  Points to perturbate
-     * @param[in] panel  Panel on which operate
-     * @return A new list of perturbated points
+     * Perturbates a set of points on a panel, in place.
+     * Every coordinate is shifted by a normal random number; numbers are
+     * drawn in batches. Points are kept on the panel.
+     * @param[in,out] x     X-coordinates of the points
+     * @param[in,out] y     Y-coordinates of the points
+     * @param[in]     size  Number of points
+     * @param[in]     panel Panel on which operate
      */
-    virtual vector<Node> perturbate(
-        const vector<Node> &nodes,
+    virtual void perturbate(
+        double *x,
+        double *y,
+        const size_t size,
         const Panel &panel) const;
 
 
@@ -13,7 +13,7 @@
  * You should have received a copy of the GNU General Public License
  * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <vector>
+#include <cstddef>
 
 #include "Null.h"
 
@@ -23,14 +23,15 @@ Null::~Null() {
 }
 
 
-vector<Node> Null::perturbate(
-        const vector<Node> &nodes,
+void Null::perturbate(
+        double *x,
+        double *y,
+        const size_t size,
         const Panel &panel) const {
-    vector<Node> new_nodes = nodes;
-
+    (void) x;
+    (void) y;
+    (void) size;
     (void) panel;
-
-    return new_nodes;
 }
 
 }  // namespace perturbator
@@ -16,7 +16,7 @@
 #ifndef PERTURBATOR_NULL_H_
 #define PERTURBATOR_NULL_H_
 
-#include <vector>
+#include <cstddef>
 
 #include "Perturbator.h"
 
@@ -41,14 +41,17 @@ class Null: public Perturbator {
 
 
     /**
-     * Perturbates a list of points on a panel.
+     * Perturbates a set of points on a panel, in place.
      * No real perturbation takes place.
-     * @param[in] nodes  Points to perturbate
-     * @param[in] panel  Panel on which operate
-     * @return A new list of perturbated points
+     * @param[in,out] x     X-coordinates of the points
+     * @param[in,out] y     Y-coordinates of the points
+     * @param[in]     size  Number of points
+     * @param[in]     panel Panel on which operate
      */
-    virtual vector<Node> perturbate(
-        const vector<Node> &nodes,
+    virtual void perturbate(
+        double *x,
+        double *y,
+        const size_t size,
         const Panel &panel) const;
 };
 
@@ -25,7 +25,22 @@ Perturbator::~Perturbator() {
 
 vector<Node>
 Perturbator::operator()(const vector<Node> &nodes, const Panel &panel) const {
-    return perturbate(nodes, panel);
+    NodeSet set(nodes);
+
+    (*this)(&set, panel);
+    return set.getNodesAsVector();
+}
+
+
+void
+Perturbator::operator()(
+    NodeSet *nodes,
+    const Panel &panel,
+    const size_t first) const {
+    if (nodes->getSize() > first) {
+        perturbate(nodes->getX() + first, nodes->getY() + first,
+                   nodes->getSize() - first, panel);
+    }
 }
 
 }  // namespace perturbator
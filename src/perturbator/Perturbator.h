@@ -16,9 +16,11 @@
 #ifndef PERTURBATOR_PERTURBATOR_H_
 #define PERTURBATOR_PERTURBATOR_H_
 
+#include <cstddef>
 #include <vector>
 
 #include "../Node.h"
+#include "../NodeSet.h"
 #include "../Panel.h"
 
 using std::vector;
@@ -28,6 +30,8 @@ namespace perturbator {
 /**
  * Perturbates a list of nodes.
  * Perturbation should be such that points stays on the panel.
+ * Nodes are moved in place, on their coordinate arrays: nothing is
+ * allocated and identifiers are kept.
  * 
  * This class follows the Strategy Design Pattern.
  *
@@ -45,7 +49,7 @@ class Perturbator {
      * Perturbates a list of points on a panel.
      * @param[in] nodes  Points to perturbate
      * @param[in] panel  Panel on which operate
-     * @return A new list of perturbated points
+     * @return A new list of perturbated points, with the same identifiers
      */
     vector<Node> operator()(
         const vector<Node> &nodes,
@@ -53,13 +57,29 @@ class Perturbator {
 
 
     /**
-     * Perturbates a list of points on a panel.
-     * @param[in] nodes  Points to perturbate
-     * @param[in] panel  Panel on which operate
-     * @return A new list of perturbated points
+     * Perturbates a set of points on a panel, in place.
+     * @param[in,out] nodes Points to perturbate
+     * @param[in]     panel Panel on which operate
+     * @param[in]     first Position of the first point to perturbate,
+     *                      points before it are left untouched
      */
-    virtual vector<Node> perturbate(
-        const vector<Node> &nodes,
+    void operator()(
+        NodeSet *nodes,
+        const Panel &panel,
+        const size_t first = 0) const;
+
+
+    /**
+     * Perturbates a set of points on a panel, in place.
+     * @param[in,out] x     X-coordinates of the points
+     * @param[in,out] y     Y-coordinates of the points
+     * @param[in]     size  Number of points
+     * @param[in]     panel Panel on which operate
+     */
+    virtual void perturbate(
+        double *x,
+        double *y,
+        const size_t size,
         const Panel &panel) const = 0;
 };
 
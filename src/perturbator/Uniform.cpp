@@ -17,24 +17,32 @@
 #include <time.h>
 #include <unistd.h>
 
-#include <vector>
+#include <cstddef>
 
 #include "Uniform.h"
 #include "../RNG.h"
 
 namespace perturbator {
 
+/** Number of nodes perturbated with a batch of random numbers. */
+static const size_t NODES_PER_BATCH = 256;
+
+
 /**
- * Ensures given value to be in [min, max].
- * @param[in, out] value Value to check and modify
- * @param[in]      min   Minimum allowed value
- * @param[in]      max   Maximum allowed value
+ * Ensures given values to be in [min, max].
+ * @param[in,out] values Values to check and modify
+ * @param[in]     size   Number of values
+ * @param[in]     min    Minimum allowed value
+ * @param[in]     max    Maximum allowed value
  */
-static void check_limits(double *value, const double min, const double max) {
-    if (*value < min) {
-        *value = min;
-    } else if (*value > max) {
-        *value = max;
+static void check_limits(
+    double *values,
+    const size_t size,
+    const double min,
+    const double max) {
+    for (size_t i = 0; i < size; i++) {
+        const double value = values[i];
+        values[i] = (value < min) ? min : ((value > max) ? max : value);
     }
 }
 
@@ -48,23 +56,28 @@ Uniform::~Uniform() {
 }
 
 
-vector<Node>
+void
 Uniform::perturbate(
-    const vector<Node> &nodes,
+    double *x,
+    double *y,
+    const size_t size,
     const Panel &panel) const {
-    vector<Node> newNodes;
+    double noise[2 * NODES_PER_BATCH];
     RNG rng;
 
-    for (unsigned int i = 0; i < nodes.size(); i++) {
-        double x = nodes[i].getX() + rng.uniform(-magnitude, +magnitude),
-               y = nodes[i].getY() + rng.uniform(-magnitude, +magnitude);
-
-        check_limits(&x, 0.0, panel.getWidth());
-        check_limits(&y, 0.0, panel.getHeight());
-        newNodes.push_back(Node(x, y));
+    for (size_t first = 0; first < size; first += NODES_PER_BATCH) {
+        const size_t n = (first + NODES_PER_BATCH < size)
+                       ? NODES_PER_BATCH
+                       : size - first;
+        rng.uniform(noise, 2 * n, -magnitude, +magnitude);
+        for (size_t i = 0; i < n; i++) {
+            x[first + i] += noise[2 * i];
+            y[first + i] += noise[2 * i + 1];
+        }
     }
 
-    return newNodes;
+    check_limits(x, size, 0.0, panel.getWidth());
+    check_limits(y, size, 0.0, panel.getHeight());
 }
 
 }  // namespace perturbator
@@ -16,7 +16,7 @@
 #ifndef PERTURBATOR_UNIFORM_H_
 #define PERTURBATOR_UNIFORM_H_
 
-#include <vector>
+#include <cstddef>
 
 #include "Perturbator.h"
 
@@ -47,15 +47,19 @@ class Uniform: public Perturbator {
 
 
     /**
-     * Perturbates a list of points on a panel.
+     * Perturbates a set of points on a panel, in place.
      * Points coordinates are perturbated, altering their coordinates
-     * up to a given magnitude (in each dimension).
-     * @param[in] nodes  Points to perturbate
-     * @param[in] panel  Panel on which operate
-     * @return A new list of perturbated points
+     * up to a given magnitude (in each dimension). Points are kept on the
+     * panel.
+     * @param[in,out] x     X-coordinates of the points
+     * @param[in,out] y     Y-coordinates of the points
+     * @param[in]     size  Number of points
+     * @param[in]     panel Panel on which operate
      */
-    virtual vector<Node> perturbate(
-        const vector<Node> &nodes,
+    virtual void perturbate(
+        double *x,
+        double *y,
+        const size_t size,
         const Panel &panel) const;
 
 
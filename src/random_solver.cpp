@@ -17,10 +17,12 @@
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <stdint.h>
 
 #include <iostream>
 
 #include "Stopwatch.h"
+#include "RNG.h"
 #include "Instance.h"
 #include "Solution.h"
 #include "solver/Random.h"
@@ -44,9 +46,18 @@ static void show_helper(int argc, char *argv[]) {
          << "standard output.\n"
          << endl
          << "Usage:\n"
-         << "  " << argv[0] << " -h" << endl
+         << "  " << argv[0] << " -r <int> -f <file> -h" << endl
          << endl
-         << "  -h    \t Prints this help and exits\n";
+         << "Options:\n"
+         << "  -r <int>  \t Seed of the random numbers (default: depends on\n"
+         << "            \t time and process)\n"
+         << "  -f <file> \t Reads instance from file instead of standard\n"
+         << "            \t input (binary instances are memory-mapped)\n"
+         << "  -h        \t Prints this help and exits\n"
+         << endl
+         << "Environment:\n"
+         << "  MEMOC_THREADS \t Number of threads (default: number of\n"
+         << "                \t online processors)\n";
 }
 
 
@@ -59,12 +70,17 @@ static void show_helper(int argc, char *argv[]) {
  */
 int main(int argc, char *argv[]) {
     int opt;
+    const char *path = NULL;
+    bool seeded = false;
+    uint64_t seed = 0;
 
     /*******************************************************************
      * Command line options parsing.
      ******************************************************************/
-    while ((opt = getopt(argc, argv, "h")) != -1) {
+    while ((opt = getopt(argc, argv, "r:f:h")) != -1) {
         switch (opt) {
+        case 'r': seed = strtoull(optarg, NULL, 10); seeded = true; break;
+        case 'f': path = optarg; break;
         case 'h':
             show_helper(argc, argv);
             exit(EXIT_SUCCESS);
@@ -80,8 +96,14 @@ int main(int argc, char *argv[]) {
     /*******************************************************************
      * Runs the solver.
      ******************************************************************/
+    if (seeded) {
+        RNG::setMasterSeed(seed);
+    }
+
     Stopwatch sw;
-    Instance instance = Instance::load(&std::cin);
+    Instance instance = (path != NULL)
+                      ? Instance::open(path)
+                      : Instance::load(&std::cin);
     solver::Random solver;
 
     sw.start();
@@ -41,6 +41,10 @@ using std::vector;
 
 namespace solver {
 
+CPLEX::CPLEX(const int seed): seed(seed) {
+}
+
+
 CPLEX::~CPLEX() {
 }
 
@@ -53,17 +57,21 @@ Solution CPLEX::solve(const Instance &instance) const {
     unsigned int i, j, k;
     vector<Node> nodes(instance.getNodesAsVector()), solution;
     const unsigned int N = nodes.size();
+    vector<double> costs(N * N);
     vector<Node*> projection(N);
     vector<double> ones;
     map< int, map<int, bool> > skip_arc;
 
 
     // Pre-calculates some support informations
+    for (i = 0; i < N; i++) {
+        instance.getCostRow(i, &costs[i * N]);
+    }
     for (i = 0; i < N; i++) {
         projection[i] = &nodes[i];
         ones.push_back(1.0);
         for (j = 0; j < N; j++) {
-            bool arc = instance.hasArc(nodes[i].getId(), nodes[j].getId());
+            bool arc = costs[i * N + j] >= 0;
             skip_arc[i][j] = !arc;
         }
     }
@@ -71,6 +79,9 @@ Solution CPLEX::solve(const Instance &instance) const {
 
     // TSP is a minimization problem
     cplex.setMin();
+    if (seed >= 0) {
+        cplex.setSeed(seed);
+    }
 
 
 
@@ -90,7 +101,7 @@ Solution CPLEX::solve(const Instance &instance) const {
         for (j = 0; j < N; j++) {
             SKIP_NON_EXISTING_ARCS(instance, i, j);
 
-            double c = instance.getCost(nodes[i].getId(), nodes[j].getId());
+            double c = costs[i * N + j];
             snprintf(name, sizeof(name), "y_%u_%u", i, j);
             cplex.addBooleanVar(name, c);
         }
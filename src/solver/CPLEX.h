@@ -31,6 +31,14 @@ namespace solver {
  */
 class CPLEX: public Solver {
  public:
+    /**
+     * Constructor.
+     * @param[in] seed Seed of the random numbers used by CPLEX, negative
+     *                 to keep the default one
+     */
+    explicit CPLEX(const int seed = -1);
+
+
     /**
      * Destructor.
      */
@@ -44,6 +52,10 @@ class CPLEX: public Solver {
      * @return Solution of that instance
      */
     virtual Solution solve(const Instance &instance) const;
+
+
+ private:
+    int seed;  ///< Seed of CPLEX, negative for the default one
 };
 
 }  // namespace solver
@@ -160,6 +160,12 @@ CPLEXManager &CPLEXManager::setMax() {
 }
 
 
+CPLEXManager &CPLEXManager::setSeed(const int seed) {
+    CPX_CALL(CPXsetintparam(environment, CPX_PARAM_RANDOMSEED, seed));
+    return *this;
+}
+
+
 
 CPLEXManager &CPLEXManager::solve() {
     int type;
@@ -180,6 +180,14 @@ class CPLEXManager {
     CPLEXManager &setMax();
 
 
+    /**
+     * Sets the seed of the random numbers used by CPLEX.
+     * @param[in] seed Seed
+     * @return This CPLEXManager itself
+     */
+    CPLEXManager &setSeed(const int seed);
+
+
     /**
      * Solves the problem.
      * @return This CPLEXManager itself
@@ -16,9 +16,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 #include "Chromosome.h"
 #include "../RNG.h"
+#include "../Stopwatch.h"
 
 
 /**
@@ -37,26 +39,173 @@
         MALLOC_ERROR;                             \
     }
 
-/** Random number generator. */
-static RNG rng;
-
 
 
 ////////////////////////////////////////////////////////////////////////
 // Support functions
 
+/** Longest portion of a chromosome moved by Or-opt. */
+static const unsigned int MAX_PORTION = 3;
+
+
+/**
+ * Type used to sum costs of type T.
+ * Integer costs are summed exactly.
+ */
+template <typename T>
+struct Accumulator {
+    typedef double Type;               ///< Type of the sum
+    static const bool exact = false;  ///< Whether sums are exact
+};
+
+template <>
+struct Accumulator<int32_t> {
+    typedef int64_t Type;             ///< Type of the sum
+    static const bool exact = true;  ///< Whether sums are exact
+};
+
+
+/**
+ * Stored costs of a dense matrix with elements of type T.
+ * Views on stored costs tell the stored cost of the arc between two
+ * genes, negative if there is no such arc; they are small enough to be
+ * copied by value.
+ */
+template <typename T>
+struct BlockCosts {
+    typedef T Value;  ///< Type of the stored costs
+    const T *block;   ///< Stored costs, row major
+    size_t N;         ///< Number of genes
+
+    /** Returns stored cost of arc (a, b). */
+    T operator()(const unsigned int a, const unsigned int b) const {
+        return block[a * N + b];
+    }
+};
+
+
+/**
+ * Stored costs of a symmetric matrix, upper triangle only.
+ * Row i of the triangle starts at Triangular::offset(N, i).
+ */
+struct TriangleCosts {
+    typedef double Value;  ///< Type of the stored costs
+    const double *block;   ///< Upper triangle, row major
+    size_t N;              ///< Number of genes
+
+    /** Returns stored cost of arc (a, b). */
+    double operator()(const unsigned int a, const unsigned int b) const {
+        const size_t i = (a < b) ? a : b,
+                     j = (a < b) ? b : a;
+        return block[i * (2 * N - i + 1) / 2 + (j - i)];
+    }
+};
+
+
+/**
+ * Stored costs of a sparse or lazy matrix.
+ * Costs are looked up by the matrix itself, so that it is never
+ * expanded.
+ */
+struct MatrixCosts {
+    typedef double Value;          ///< Type of the stored costs
+    const matrix::Matrix *matrix;  ///< Cost matrix
+
+    /** Returns stored cost of arc (a, b). */
+    double operator()(const unsigned int a, const unsigned int b) const {
+        return matrix->get(a, b);
+    }
+};
+
+
+/**
+ * Calls an action on the view fitting the stored costs of a matrix.
+ * Action must take any view on stored costs.
+ * @param[in]      matrix Cost matrix
+ * @param[in, out] action Action to call
+ */
+template <typename A>
+static void dispatch(const solver::CostMatrix *matrix, A *action) {
+    switch (matrix->storage) {
+    case Instance::DENSE:
+        if (matrix->precision == Instance::FLOAT) {
+            const BlockCosts<float> costs = {
+                static_cast<const float *>(matrix->costs), matrix->size};
+            (*action)(costs);
+        } else if (matrix->precision == Instance::FIXED) {
+            const BlockCosts<int32_t> costs = {
+                static_cast<const int32_t *>(matrix->costs), matrix->size};
+            (*action)(costs);
+        } else {
+            const BlockCosts<double> costs = {
+                static_cast<const double *>(matrix->costs), matrix->size};
+            (*action)(costs);
+        }
+        break;
+
+    case Instance::TRIANGULAR: {
+        const TriangleCosts costs = {
+            static_cast<const double *>(matrix->costs), matrix->size};
+        (*action)(costs);
+        break;
+    }
+
+    default: {
+        const MatrixCosts costs = {matrix->matrix};
+        (*action)(costs);
+    }
+    }
+}
+
+
+/**
+ * Evaluates a chromosome on stored costs.
+ * @param[in, out] chromosome Chromosome to evaluate
+ * @param[in]      costs      Stored costs
+ * @param[in]      scale      Scale factor of the stored costs
+ */
+template <typename C>
+static void evaluate(
+    solver::Chromosome *chromosome,
+    const C &costs,
+    const double scale) {
+    typedef typename C::Value T;
+    const unsigned int size = chromosome->size;
+    unsigned int i;
+    unsigned int *genes = chromosome->genes;
+    typename Accumulator<T>::Type sum = 0;
+    double cost;
+
+    for (i = 0; i < size; i++) {
+        const T arc = costs(genes[i], genes[(i + 1) % size]);
+        if (arc < 0) {
+            break;
+        }
+        sum += arc;
+    }
+    cost = (i < size) ? -1.0 : sum / scale;
+
+    chromosome->fitness = 1.0 / cost;
+    chromosome->length  = (Accumulator<T>::exact && i == size)
+                        ? static_cast<int64_t>(sum)
+                        : -1;
+}
+
+
 /**
  * Copies a chromosome with a reversed portion.
  * Source chromosome is copied into destination one, with positions from
  * i to j in reverse order.
  * @note Source and destination chromosomes must be different
  */
+template <typename C>
 static void copy_and_reverse(
     solver::Chromosome *dst,
     const solver::Chromosome *src,
     const unsigned int i,
     const unsigned int j,
-    const double *costs) {
+    const C &costs,
+    const double scale) {
     const unsigned int N = src->size;
 
     for (unsigned int k = 0; k < i; k++) {
@@ -72,10 +221,968 @@ static void copy_and_reverse(
         dst->genes[k] = src->genes[k];
     }
 
-    chromosome_evaluate(dst, costs);
+    evaluate(dst, costs, scale);
+}
+
+
+
+/**
+ * Performs a two-opt improvement on symmetric costs.
+ * Reversing positions from i to j replaces arcs entering i and leaving j
+ * only, since reversed arcs keep their costs: every move is evaluated in
+ * constant time from the four arcs involved, and the best one is applied.
+ * Chromosome must be feasible.
+ * @param[in, out] chromosome Chromosome to improve
+ * @param[in]      costs      Stored costs
+ * @param[in]      scale      Scale factor of the stored costs
+ */
+template <typename C>
+static void two_opt_symmetric(
+    solver::Chromosome *chromosome,
+    const C &costs,
+    const double scale) {
+    typedef typename C::Value T;
+    typedef typename Accumulator<T>::Type Sum;
+    const unsigned int N = chromosome->size;
+    unsigned int *genes = chromosome->genes;
+    unsigned int best_i = 0, best_j = 0;
+    Sum best_delta = 0;
+
+    // Tries every possible 2-opt combination
+    for (unsigned int i = 1; i < N; i++) {
+        const unsigned int before = genes[i - 1],
+                           first  = genes[i];
+        const Sum removed = costs(before, first);
+        for (unsigned int j = i + 1; j < N; j++) {
+            const unsigned int next = genes[(j + 1) % N];
+            const T in  = costs(before, genes[j]),
+                    out = costs(first, next);
+            if (in < 0 || out < 0) {
+                continue;
+            }
+
+            const Sum delta = static_cast<Sum>(in) + out
+                            - removed - costs(genes[j], next);
+            if (best_i == 0 || delta < best_delta) {
+                best_i     = i;
+                best_j     = j;
+                best_delta = delta;
+            }
+        }
+    }
+
+    // Applies best move, if any
+    if (best_i == 0) {
+        return;
+    }
+    for (unsigned int k = 0; k <= (best_j - best_i) / 2; k++) {
+        const unsigned int swap = genes[best_i + k];
+        genes[best_i + k] = genes[best_j - k];
+        genes[best_j - k] = swap;
+    }
+    evaluate(chromosome, costs, scale);
+}
+
+
+/**
+ * Sums arcs along a chromosome, forwards and backwards.
+ * Element k of the sums covers the first k arcs of the chromosome, the
+ * last one closing the cycle; backward sums take the reversed arcs, and
+ * reversed arcs which do not exist are counted apart.
+ * @param[in]  genes    Genes of the chromosome
+ * @param[in]  N        Number of genes
+ * @param[in]  costs    Stored costs
+ * @param[out] forward  Sums of the arcs, N + 1 elements
+ * @param[out] backward Sums of the reversed arcs, N + 1 elements
+ * @param[out] missing  Reversed arcs which do not exist, N + 1 elements
+ */
+template <typename C>
+static void sum_arcs(
+    const unsigned int *genes,
+    const unsigned int N,
+    const C &costs,
+    typename Accumulator<typename C::Value>::Type *forward,
+    typename Accumulator<typename C::Value>::Type *backward,
+    unsigned int *missing) {
+    forward[0]  = 0;
+    backward[0] = 0;
+    missing[0]  = 0;
+    for (unsigned int k = 0; k < N; k++) {
+        const unsigned int a = genes[k],
+                           b = genes[(k + 1) % N];
+        const typename C::Value back = costs(b, a);
+        forward[k + 1]  = forward[k] + costs(a, b);
+        backward[k + 1] = backward[k] + ((back < 0) ? 0 : back);
+        missing[k + 1]  = missing[k] + (back < 0);
+    }
+}
+
+
+/**
+ * Returns the sum of the arcs along a path of a chromosome.
+ * Path may wrap around the end of the chromosome.
+ * @param[in] sums  Sums of the arcs, as built by sum_arcs()
+ * @param[in] N     Number of genes
+ * @param[in] first Position of the first gene of the path
+ * @param[in] last  Position of the last gene of the path
+ * @return Sum of the arcs from first to last
+ */
+template <typename S>
+static inline S along(
+    const S *sums,
+    const unsigned int N,
+    const unsigned int first,
+    const unsigned int last) {
+    return (first <= last)
+         ? sums[last] - sums[first]
+         : sums[N] - sums[first] + sums[last];
+}
+
+
+/**
+ * State of a local search on a chromosome.
+ * Positions of the genes and sums of the arcs follow every move.
+ */
+template <typename C>
+struct LocalSearch {
+    typedef typename C::Value Value;                ///< Type of the costs
+    typedef typename Accumulator<Value>::Type Sum;  ///< Type of the sums
+
+    unsigned int *genes;     ///< Genes of the chromosome
+    unsigned int *position;  ///< Position of each gene
+    unsigned int N;          ///< Number of genes
+    C costs;                 ///< Stored costs
+    Sum *forward;            ///< Sums of the arcs
+    Sum *backward;           ///< Sums of the reversed arcs
+    unsigned int *missing;   ///< Reversed arcs which do not exist
+    unsigned int *portion;   ///< Room for a relocated portion
+};
+
+
+/**
+ * A move of a local search.
+ * Either a reversal of the portion from position i to position j
+ * (2-opt), or a relocation of the portion of given length starting at
+ * position i, after the gene at position j (Or-opt).
+ */
+struct move_s {
+    bool relocation;     ///< Whether the move is a relocation
+    unsigned int i;      ///< First position of the portion
+    unsigned int j;      ///< Last position, or position to move after
+    unsigned int length; ///< Length of a relocated portion
+    bool reversed;       ///< Whether a relocated portion is reversed
+};
+
+/** Type of a move of a local search. */
+typedef struct move_s Move;
+
+
+/**
+ * Starts a local search on a chromosome.
+ * @param[out] search     State of the search
+ * @param[in]  chromosome Chromosome to improve
+ * @param[in]  costs      Stored costs
+ * @note search_delete must be called to deallocate resources
+ */
+template <typename C>
+static void search_create(
+    LocalSearch<C> *search,
+    solver::Chromosome *chromosome,
+    const C &costs) {
+    typedef typename LocalSearch<C>::Sum Sum;
+    const unsigned int N = chromosome->size;
+
+    search->genes = chromosome->genes;
+    search->N     = N;
+    search->costs = costs;
+    SAFE_MALLOC(search->position, unsigned int *, N * sizeof(unsigned int));
+    SAFE_MALLOC(search->forward, Sum *, (N + 1) * sizeof(Sum));
+    SAFE_MALLOC(search->backward, Sum *, (N + 1) * sizeof(Sum));
+    SAFE_MALLOC(search->missing, unsigned int *,
+                (N + 1) * sizeof(unsigned int));
+    SAFE_MALLOC(search->portion, unsigned int *, N * sizeof(unsigned int));
+
+    for (unsigned int p = 0; p < N; p++) {
+        search->position[search->genes[p]] = p;
+    }
+    sum_arcs(search->genes, N, costs,
+             search->forward, search->backward, search->missing);
+}
+
+
+/**
+ * Ends a local search.
+ * @param[in, out] search State of the search
+ */
+template <typename C>
+static void search_delete(LocalSearch<C> *search) {
+    free(search->position);
+    free(search->forward);
+    free(search->backward);
+    free(search->missing);
+    free(search->portion);
+}
+
+
+/**
+ * Returns the improvements ignored by a local search.
+ * Floating point sums are not exact: tiny improvements are ignored, so
+ * that rounding errors cannot make the search cycle.
+ * @param[in] search State of the search
+ * @return Smallest improvement taken into account
+ */
+template <typename C>
+static typename LocalSearch<C>::Sum
+search_tolerance(const LocalSearch<C> *search) {
+    typedef typename LocalSearch<C>::Sum Sum;
+    return Accumulator<typename C::Value>::exact
+         ? 0
+         : static_cast<Sum>(search->forward[search->N] * 1e-12);
+}
+
+
+/**
+ * Evaluates the reversal of a portion of a chromosome.
+ * Portion goes from position i to position j and may wrap around the end
+ * of the chromosome; it must leave at least two genes out, so that the
+ * four genes at its ends are different.
+ * @param[in]  search State of the search
+ * @param[in]  i      Position of the first gene to reverse
+ * @param[in]  j      Position of the last gene to reverse
+ * @param[out] delta  Change of the length of the chromosome
+ * @return True iff the reversal is legal and gives a feasible chromosome
+ */
+template <typename C>
+static bool evaluate_reversal(
+    const LocalSearch<C> *search,
+    const unsigned int i,
+    const unsigned int j,
+    typename LocalSearch<C>::Sum *delta) {
+    typedef typename LocalSearch<C>::Sum Sum;
+    typedef typename LocalSearch<C>::Value T;
+    const unsigned int N      = search->N,
+                       length = (j + N - i) % N + 1,
+                       before = (i + N - 1) % N,
+                       after  = (j + 1) % N;
+    const unsigned int *genes = search->genes;
+
+    if (length < 2 || length > N - 2 ||
+        along(search->missing, N, i, j) != 0) {
+        return false;
+    }
+
+    const T in  = search->costs(genes[before], genes[j]),
+            out = search->costs(genes[i], genes[after]);
+    if (in < 0 || out < 0) {
+        return false;
+    }
+
+    *delta = static_cast<Sum>(in) + out
+           + along(search->backward, N, i, j)
+           - along(search->forward, N, before, after);
+    return true;
+}
+
+
+/**
+ * Evaluates the relocation of a portion of a chromosome.
+ * Portion starts at position i and may wrap around the end of the
+ * chromosome; it is moved between the gene at position j and the next
+ * one, both out of the portion. Arcs inside a portion which keeps its
+ * orientation do not change, so that only the three arcs removed and the
+ * three arcs added count; a reversed portion also turns its inner arcs.
+ * @param[in]  search   State of the search
+ * @param[in]  i        Position of the first gene of the portion
+ * @param[in]  length   Number of genes in the portion
+ * @param[in]  j        Position of the gene to move the portion after
+ * @param[in]  reversed Whether the portion is reversed
+ * @param[out] delta    Change of the length of the chromosome
+ * @return True iff the relocation is legal and gives a feasible
+ *         chromosome
+ */
+template <typename C>
+static bool evaluate_relocation(
+    const LocalSearch<C> *search,
+    const unsigned int i,
+    const unsigned int length,
+    const unsigned int j,
+    const bool reversed,
+    typename LocalSearch<C>::Sum *delta) {
+    typedef typename LocalSearch<C>::Sum Sum;
+    typedef typename LocalSearch<C>::Value T;
+    const unsigned int N = search->N;
+
+    if (length + 2 > N ||
+        (j + N - i) % N < length ||
+        (j + 1 + N - i) % N < length) {
+        return false;
+    }
+
+    const unsigned int *genes = search->genes;
+    const C &costs = search->costs;
+    const unsigned int last  = (i + length - 1) % N,
+                       prev  = genes[(i + N - 1) % N],
+                       next  = genes[(last + 1) % N],
+                       x     = genes[j],
+                       y     = genes[(j + 1) % N],
+                       head  = reversed ? genes[last] : genes[i],
+                       tail  = reversed ? genes[i] : genes[last];
+    const T join = costs(prev, next),
+            in   = costs(x, head),
+            out  = costs(tail, y);
+    if (join < 0 || in < 0 || out < 0 ||
+        (reversed && along(search->missing, N, i, last) != 0)) {
+        return false;
+    }
+
+    *delta = static_cast<Sum>(join) + in + out
+           - costs(prev, genes[i])
+           - costs(genes[last], next)
+           - costs(x, y);
+    if (reversed) {
+        *delta += along(search->backward, N, i, last)
+                - along(search->forward, N, i, last);
+    }
+    return true;
+}
+
+
+/**
+ * Returns the genes at the ends of the arcs removed by a move.
+ * @param[in]  search State of the search
+ * @param[in]  move   Move
+ * @param[out] ends   Genes, six slots, some may be repeated
+ * @return Number of genes
+ */
+template <typename C>
+static unsigned int move_ends(
+    const LocalSearch<C> *search,
+    const Move *move,
+    unsigned int *ends) {
+    const unsigned int N = search->N,
+                       *genes = search->genes;
+
+    if (!move->relocation) {
+        ends[0] = genes[(move->i + N - 1) % N];
+        ends[1] = genes[move->i];
+        ends[2] = genes[move->j];
+        ends[3] = genes[(move->j + 1) % N];
+        return 4;
+    }
+
+    const unsigned int last = (move->i + move->length - 1) % N;
+    ends[0] = genes[(move->i + N - 1) % N];
+    ends[1] = genes[move->i];
+    ends[2] = genes[last];
+    ends[3] = genes[(last + 1) % N];
+    ends[4] = genes[move->j];
+    ends[5] = genes[(move->j + 1) % N];
+    return 6;
+}
+
+
+/**
+ * Moves the genes of a chromosome, following their positions.
+ * A relocated portion travels through the shorter side of the cycle; a
+ * portion keeping its orientation which is longer than the genes it
+ * jumps over swaps places with them instead. Sums of the arcs are left
+ * as they are.
+ * @param[in, out] search State of the search
+ * @param[in]      move   Move to apply
+ */
+template <typename C>
+static void move_genes(LocalSearch<C> *search, const Move *move) {
+    const unsigned int N = search->N;
+    unsigned int *genes    = search->genes,
+                 *position = search->position;
+
+    if (!move->relocation) {
+        const unsigned int length = (move->j + N - move->i) % N + 1;
+        for (unsigned int t = 0; t < length / 2; t++) {
+            const unsigned int x    = (move->i + t) % N,
+                               y    = (move->j + N - t) % N,
+                               swap = genes[x];
+            genes[x] = genes[y];
+            genes[y] = swap;
+            position[genes[x]] = x;
+            position[genes[y]] = y;
+        }
+    } else {
+        unsigned int i      = move->i,
+                     length = move->length,
+                     j      = move->j;
+        if (!move->reversed && (j + N - i) % N + 1 - length < length) {
+            const unsigned int jumped = (j + N - i) % N + 1 - length;
+            j      = (i + N - 1) % N;
+            i      = (i + length) % N;
+            length = jumped;
+        }
+
+        const unsigned int last   = (i + length - 1) % N,
+                           after  = (j + N - last) % N,
+                           before = N - length - after;
+        unsigned int *portion = search->portion, first;
+
+        for (unsigned int t = 0; t < length; t++) {
+            portion[t] = genes[(i + t) % N];
+        }
+
+        if (after <= before) {
+            // Genes up to j go back to where the portion was
+            for (unsigned int t = 0; t < after; t++) {
+                const unsigned int p = (i + t) % N;
+                genes[p] = genes[(last + 1 + t) % N];
+                position[genes[p]] = p;
+            }
+            first = (i + after) % N;
+        } else {
+            // Genes after j up to the portion go forward
+            for (unsigned int t = before; t-- > 0;) {
+                const unsigned int p = (j + 1 + length + t) % N;
+                genes[p] = genes[(j + 1 + t) % N];
+                position[genes[p]] = p;
+            }
+            first = (j + 1) % N;
+        }
+
+        for (unsigned int t = 0; t < length; t++) {
+            const unsigned int p = (first + t) % N;
+            genes[p] = portion[move->reversed ? length - 1 - t : t];
+            position[genes[p]] = p;
+        }
+    }
+}
+
+
+/**
+ * Applies a move, following positions of the genes and sums of the arcs.
+ * @param[in, out] search State of the search
+ * @param[in]      move   Move to apply
+ */
+template <typename C>
+static void apply_move(LocalSearch<C> *search, const Move *move) {
+    move_genes(search, move);
+    sum_arcs(search->genes, search->N, search->costs,
+             search->forward, search->backward, search->missing);
+}
+
+
+/**
+ * Improves a chromosome with moves on candidate neighbours.
+ * Every gene waits in a queue. When a gene leaves it, moves giving the
+ * gene a candidate successor or predecessor are evaluated in constant
+ * time each: two 2-opt moves per candidate and, for every portion up to
+ * given length starting or ending at the gene, an Or-opt move per
+ * candidate. The best improving move is applied and the genes at the
+ * ends of the removed arcs go back into the queue. A gene left out of
+ * the queue has its don't-look bit set: it is not tried again until a
+ * move touches it. Search stops when the queue drains or time runs out.
+ * Moves may wrap around the end of the chromosome.
+ * Chromosome must be feasible.
+ * @param[in, out] chromosome  Chromosome to improve
+ * @param[in]      costs       Stored costs
+ * @param[in]      matrix      Cost matrix, with candidate neighbours
+ * @param[in]      max_portion Longest portion moved by Or-opt, 0 for none
+ * @param[in, out] sw          Stopwatch started with the search
+ * @param[in]      max_time    Maximum execution time, 0 for no limit
+ */
+template <typename C>
+static void neighbour_search(
+    solver::Chromosome *chromosome,
+    const C &costs,
+    const solver::CostMatrix *matrix,
+    const unsigned int max_portion,
+    Stopwatch *sw,
+    const double max_time) {
+    typedef typename LocalSearch<C>::Sum Sum;
+    const unsigned int N = chromosome->size,
+                       k = matrix->k;
+    unsigned int *queue, head = 0, waiting = N;
+    bool *queued;
+    LocalSearch<C> search;
+
+    search_create(&search, chromosome, costs);
+    SAFE_MALLOC(queue, unsigned int *, N * sizeof(unsigned int));
+    SAFE_MALLOC(queued, bool *, N * sizeof(bool));
+    for (unsigned int p = 0; p < N; p++) {
+        queue[p]  = search.genes[p];
+        queued[p] = true;
+    }
+
+    const Sum tolerance = search_tolerance(&search);
+    while (waiting > 0) {
+        if (max_time > 0.0 && sw->stop().getUserTime() >= max_time) {
+            break;
+        }
+
+        const unsigned int a = queue[head],
+                           p = search.position[a];
+        const unsigned int *out = matrix->successors + a * k,
+                           *in  = matrix->predecessors + a * k;
+        const unsigned int n_out = matrix->n_successors[a],
+                           n_in  = matrix->n_predecessors[a];
+        Sum best_delta = -tolerance, delta;
+        Move best, move;
+        bool found = false;
+
+        head = (head + 1) % N;
+        waiting--;
+        queued[a] = false;
+
+        for (unsigned int t = 0; t < n_out + n_in; t++) {
+            const bool successor = t < n_out;
+            const unsigned int q = successor
+                                 ? search.position[out[t]]
+                                 : search.position[in[t - n_out]];
+
+            // Arc (from, to) is made by reversing the portion after from
+            // up to to, or the portion from from up to the gene before to
+            const unsigned int from = successor ? p : q,
+                               to   = successor ? q : p;
+            move.relocation = false;
+            for (unsigned int m = 0; m < 2; m++) {
+                move.i = (m == 0) ? (from + 1) % N : from;
+                move.j = (m == 0) ? to : (to + N - 1) % N;
+                if (evaluate_reversal(&search, move.i, move.j, &delta) &&
+                    delta < best_delta) {
+                    found      = true;
+                    best       = move;
+                    best_delta = delta;
+                }
+            }
+
+            // Or, by moving a portion starting or ending at the gene
+            // next to the candidate: successors follow the tail of the
+            // moved portion, predecessors precede its head
+            move.relocation = true;
+            move.j = successor ? (q + N - 1) % N : q;
+            for (move.length = 1; move.length <= max_portion;
+                 move.length++) {
+                for (unsigned int end = 0; end < 2; end++) {
+                    if (move.length == 1 && end == 1) {
+                        break;
+                    }
+                    move.i        = (end == 0) ? p
+                                             : (p + N + 1 - move.length) % N;
+                    move.reversed = move.length > 1
+                                 && (successor == (end == 0));
+                    if (evaluate_relocation(&search, move.i, move.length,
+                                            move.j, move.reversed,
+                                            &delta) &&
+                        delta < best_delta) {
+                        found      = true;
+                        best       = move;
+                        best_delta = delta;
+                    }
+                }
+            }
+        }
+
+        if (!found) {
+            continue;
+        }
+
+        // Genes at the ends of the removed arcs are dirty
+        unsigned int ends[6];
+        const unsigned int n_ends = move_ends(&search, &best, ends);
+        for (unsigned int e = 0; e < n_ends; e++) {
+            if (!queued[ends[e]]) {
+                queue[(head + waiting) % N] = ends[e];
+                queued[ends[e]] = true;
+                waiting++;
+            }
+        }
+
+        apply_move(&search, &best);
+    }
+
+    search_delete(&search);
+    free(queue);
+    free(queued);
+}
+
+
+/**
+ * A step of a chain of moves.
+ * Step relocates a portion keeping its orientation; it is undone by
+ * moving the portion back after the gene which preceded it.
+ */
+struct step_s {
+    unsigned int head;    ///< First gene of the portion
+    unsigned int length;  ///< Number of genes in the portion
+    unsigned int prev;    ///< Gene preceding the portion before the step
+};
+
+/** Type of a step of a chain of moves. */
+typedef struct step_s Step;
+
+
+/**
+ * Tells whether an arc was added by a chain of moves.
+ * @param[in] added   Arcs added by the chain, as pairs of genes
+ * @param[in] n_added Number of arcs added by the chain
+ * @param[in] from    First gene of the arc
+ * @param[in] to      Second gene of the arc
+ * @return True iff the arc was added by the chain
+ */
+static bool chain_added(
+    const unsigned int *added,
+    const unsigned int n_added,
+    const unsigned int from,
+    const unsigned int to) {
+    for (unsigned int t = 0; t < n_added; t++) {
+        if (added[2 * t] == from && added[2 * t + 1] == to) {
+            return true;
+        }
+    }
+    return false;
 }
 
 
+/**
+ * Builds a chain of sequential 3-opt moves from a gene.
+ * Every step breaks the arc leaving gene a, to b, joins a to a candidate
+ * successor d and b to a candidate predecessor e: portion from b up to
+ * c, the gene before d, is moved between e and f, its successor. Arcs
+ * (a, d) and (e, b) are kept by the rest of the chain, while arc (c, f)
+ * closes the cycle and is broken by the next step. The gain of the open
+ * chain, that is without its closing arc, must stay positive; among
+ * such steps, the one giving the shortest cycle is taken, even if longer
+ * than the current one. Chain is finally cut back to its shortest cycle.
+ * Sums of the arcs are not followed.
+ * @param[in, out] search    State of the search
+ * @param[in]      matrix    Cost matrix, with candidate neighbours
+ * @param[in]      first     Gene starting the chain
+ * @param[in]      max_depth Longest chain of moves
+ * @param[in]      steps     Room for max_depth steps
+ * @param[in]      added     Room for 2 * max_depth arcs
+ * @param[out]     ends      Genes at the ends of the arcs removed by the
+ *                           steps kept, 6 * max_depth slots
+ * @param[out]     n_ends    Number of genes in ends
+ * @return True iff the chain improves the chromosome
+ */
+template <typename C>
+static bool chain(
+    LocalSearch<C> *search,
+    const solver::CostMatrix *matrix,
+    const unsigned int first,
+    const unsigned int max_depth,
+    Step *steps,
+    unsigned int *added,
+    unsigned int *ends,
+    unsigned int *n_ends) {
+    typedef typename LocalSearch<C>::Sum Sum;
+    const unsigned int N = search->N,
+                       k = matrix->k;
+    const unsigned int *genes    = search->genes,
+                       *position = search->position;
+    const C &costs = search->costs;
+    const Sum tolerance = search_tolerance(search);
+    unsigned int a = first, depth = 0, best_depth = 0;
+    Sum total = 0, best_total = -tolerance,
+        open = costs(a, genes[(position[a] + 1) % N]);
+    Move move;
+
+    move.relocation = true;
+    move.reversed   = false;
+    while (depth < max_depth) {
+        const unsigned int i = (position[a] + 1) % N,
+                           b = genes[i];
+        const unsigned int *out = matrix->successors + a * k,
+                           *in  = matrix->predecessors + b * k;
+        unsigned int c = 0, d = 0, e = 0;
+        Sum best_delta = 0, best_open = 0, delta;
+        bool found = false;
+
+        for (unsigned int s = 0; s < matrix->n_successors[a]; s++) {
+            const unsigned int q    = position[out[s]],
+                               pred = genes[(q + N - 1) % N];
+            move.i      = i;
+            move.length = (q + N - i) % N;
+            if (move.length == 0 ||
+                chain_added(added, 2 * depth, pred, out[s])) {
+                continue;
+            }
+
+            for (unsigned int t = 0; t < matrix->n_predecessors[b]; t++) {
+                const unsigned int r    = position[in[t]],
+                                   succ = genes[(r + 1) % N];
+                move.j = r;
+                if (!evaluate_relocation(search, move.i, move.length,
+                                         move.j, false, &delta) ||
+                    chain_added(added, 2 * depth, in[t], succ)) {
+                    continue;
+                }
+
+                const Sum gain = open
+                               + costs(pred, out[s])
+                               + costs(in[t], succ)
+                               - costs(a, out[s])
+                               - costs(in[t], b);
+                if (gain > tolerance && (!found || delta < best_delta)) {
+                    found      = true;
+                    c          = pred;
+                    d          = out[s];
+                    e          = in[t];
+                    best_delta = delta;
+                    best_open  = gain;
+                }
+            }
+        }
+
+        if (!found) {
+            break;
+        }
+
+        // Applies the step, keeping track of what it did
+        move.i      = i;
+        move.length = (position[d] + N - i) % N;
+        move.j      = position[e];
+        move_ends(search, &move, ends + 6 * depth);
+        move_genes(search, &move);
+
+        steps[depth].head   = b;
+        steps[depth].length = move.length;
+        steps[depth].prev   = a;
+        added[4 * depth]     = a;
+        added[4 * depth + 1] = d;
+        added[4 * depth + 2] = e;
+        added[4 * depth + 3] = b;
+
+        depth++;
+        total += best_delta;
+        open   = best_open;
+        a      = c;
+        if (total < best_total) {
+            best_total = total;
+            best_depth = depth;
+        }
+    }
+
+    // Cuts the chain back to its best prefix
+    while (depth > best_depth) {
+        depth--;
+        move.i      = position[steps[depth].head];
+        move.length = steps[depth].length;
+        move.j      = position[steps[depth].prev];
+        move_genes(search, &move);
+    }
+
+    *n_ends = 6 * best_depth;
+    return best_depth > 0;
+}
+
+
+/**
+ * Improves a chromosome with chains of sequential 3-opt moves.
+ * Every gene waits in a queue. When a gene leaves it, a chain starts by
+ * breaking the arc leaving the gene; if the chain improves the
+ * chromosome, genes at the ends of the arcs it removed go back into the
+ * queue. Search stops when the queue drains or time runs out.
+ * Chromosome must be feasible.
+ * @param[in, out] chromosome Chromosome to improve
+ * @param[in]      costs      Stored costs
+ * @param[in]      matrix     Cost matrix, with candidate neighbours
+ * @param[in]      max_depth  Longest chain of moves
+ * @param[in, out] sw         Stopwatch started with the search
+ * @param[in]      max_time   Maximum execution time, 0 for no limit
+ * @return True iff the chromosome was improved
+ */
+template <typename C>
+static bool lin_kernighan(
+    solver::Chromosome *chromosome,
+    const C &costs,
+    const solver::CostMatrix *matrix,
+    const unsigned int max_depth,
+    Stopwatch *sw,
+    const double max_time) {
+    const unsigned int N = chromosome->size;
+    unsigned int *queue, *added, *ends, head = 0, waiting = N;
+    bool *queued, improved = false;
+    Step *steps;
+    LocalSearch<C> search;
+
+    search_create(&search, chromosome, costs);
+    SAFE_MALLOC(queue, unsigned int *, N * sizeof(unsigned int));
+    SAFE_MALLOC(queued, bool *, N * sizeof(bool));
+    SAFE_MALLOC(steps, Step *, max_depth * sizeof(Step));
+    SAFE_MALLOC(added, unsigned int *, 4 * max_depth * sizeof(unsigned int));
+    SAFE_MALLOC(ends, unsigned int *, 6 * max_depth * sizeof(unsigned int));
+    for (unsigned int p = 0; p < N; p++) {
+        queue[p]  = search.genes[p];
+        queued[p] = true;
+    }
+
+    while (waiting > 0) {
+        if (max_time > 0.0 && sw->stop().getUserTime() >= max_time) {
+            break;
+        }
+
+        const unsigned int a = queue[head];
+        unsigned int n_ends;
+
+        head = (head + 1) % N;
+        waiting--;
+        queued[a] = false;
+
+        if (!chain(&search, matrix, a, max_depth,
+                   steps, added, ends, &n_ends)) {
+            continue;
+        }
+
+        // Genes at the ends of the removed arcs are dirty
+        improved = true;
+        for (unsigned int e = 0; e < n_ends; e++) {
+            if (!queued[ends[e]]) {
+                queue[(head + waiting) % N] = ends[e];
+                queued[ends[e]] = true;
+                waiting++;
+            }
+        }
+    }
+
+    search_delete(&search);
+    free(queue);
+    free(queued);
+    free(steps);
+    free(added);
+    free(ends);
+
+    return improved;
+}
+
+
+/**
+ * Performs an Or-opt improvement.
+ * Every portion up to given length is tried between every two
+ * consecutive genes, as it is and reversed, each move evaluated in
+ * constant time; the best improving one is applied.
+ * Chromosome must be feasible.
+ * @param[in, out] chromosome  Chromosome to improve
+ * @param[in]      costs       Stored costs
+ * @param[in]      scale       Scale factor of the stored costs
+ * @param[in]      max_portion Longest portion to move
+ */
+template <typename C>
+static void or_opt(
+    solver::Chromosome *chromosome,
+    const C &costs,
+    const double scale,
+    const unsigned int max_portion) {
+    typedef typename LocalSearch<C>::Sum Sum;
+    const unsigned int N = chromosome->size;
+    LocalSearch<C> search;
+    Move best, move;
+    Sum best_delta, delta;
+    bool found = false;
+
+    search_create(&search, chromosome, costs);
+    best_delta = -search_tolerance(&search);
+
+    // Tries every possible relocation
+    move.relocation = true;
+    for (move.length = 1; move.length <= max_portion; move.length++) {
+        for (move.i = 0; move.i < N; move.i++) {
+            for (move.j = 0; move.j < N; move.j++) {
+                for (unsigned int r = 0; r < ((move.length > 1) ? 2 : 1);
+                     r++) {
+                    move.reversed = r == 1;
+                    if (evaluate_relocation(&search, move.i, move.length,
+                                            move.j, move.reversed,
+                                            &delta) &&
+                        delta < best_delta) {
+                        found      = true;
+                        best       = move;
+                        best_delta = delta;
+                    }
+                }
+            }
+        }
+    }
+
+    // Applies best move, if any
+    if (found) {
+        apply_move(&search, &best);
+        evaluate(chromosome, costs, scale);
+    }
+    search_delete(&search);
+}
+
+
+/**
+ * Performs a two-opt improvement on any costs.
+ * Reversing positions from i to j replaces arcs entering i and leaving j,
+ * and turns arcs from i to j backwards. Arcs along the chromosome are
+ * summed once, forwards and backwards, so that every move is evaluated
+ * in constant time from two prefix sums and the two new arcs; the best
+ * one is applied.
+ * Moves are chosen exactly as two_opt() does by evaluating every
+ * neighbour. Chromosome must be feasible.
+ * @param[in, out] chromosome Chromosome to improve
+ * @param[in]      costs      Stored costs
+ * @param[in]      scale      Scale factor of the stored costs
+ */
+template <typename C>
+static void two_opt_asymmetric(
+    solver::Chromosome *chromosome,
+    const C &costs,
+    const double scale) {
+    typedef typename C::Value T;
+    typedef typename Accumulator<T>::Type Sum;
+    const unsigned int N = chromosome->size;
+    unsigned int *genes = chromosome->genes, *missing;
+    unsigned int best_i = 0, best_j = 0;
+    Sum best_delta = 0, *forward, *backward;
+
+    SAFE_MALLOC(forward, Sum *, (N + 1) * sizeof(Sum));
+    SAFE_MALLOC(backward, Sum *, (N + 1) * sizeof(Sum));
+    SAFE_MALLOC(missing, unsigned int *, (N + 1) * sizeof(unsigned int));
+
+    sum_arcs(genes, N, costs, forward, backward, missing);
+
+    // Tries every possible 2-opt combination
+    for (unsigned int i = 1; i < N; i++) {
+        const unsigned int before = genes[i - 1],
+                           first  = genes[i];
+        for (unsigned int j = i + 1; j < N; j++) {
+            // Reversed portion would keep a missing arc from now on
+            if (missing[j] != missing[i]) {
+                break;
+            }
+
+            const T in  = costs(before, genes[j]),
+                    out = costs(first, genes[(j + 1) % N]);
+            if (in < 0 || out < 0) {
+                continue;
+            }
+
+            const Sum delta = static_cast<Sum>(in) + out
+                            + (backward[j] - backward[i])
+                            - (forward[j + 1] - forward[i - 1]);
+            if (best_i == 0 || delta < best_delta) {
+                best_i     = i;
+                best_j     = j;
+                best_delta = delta;
+            }
+        }
+    }
+
+    free(forward);
+    free(backward);
+    free(missing);
+
+    // Applies best move, if any
+    if (best_i == 0) {
+        return;
+    }
+    for (unsigned int k = 0; k <= (best_j - best_i) / 2; k++) {
+        const unsigned int swap = genes[best_i + k];
+        genes[best_i + k] = genes[best_j - k];
+        genes[best_j - k] = swap;
+    }
+    evaluate(chromosome, costs, scale);
+}
+
 
 /**
  * Performs a two-opt improvement.
@@ -83,22 +1190,40 @@ static void copy_and_reverse(
  * to fix the cycle; then selects best combination.
  * If no feasible alternative exists, chromosome is left as it is.
  * @param[in, out] chromosome Chromosome to improve
- * @param[in]      costs      Cost matrix
+ * @param[in]      costs      Stored costs
+ * @param[in]      scale      Scale factor of the stored costs
+ * @param[in]      symmetric  Whether costs are symmetric
  */
-static void two_opt(solver::Chromosome *chromosome, const double *costs) {
+template <typename C>
+static void two_opt(
+    solver::Chromosome *chromosome,
+    const C &costs,
+    const double scale,
+    const bool symmetric) {
     const unsigned int N = chromosome->size;
     unsigned int i, j;
     solver::Chromosome neighbor, best;
 
+    if (symmetric && chromosome->fitness > 0.0) {
+        two_opt_symmetric(chromosome, costs, scale);
+        return;
+    }
+    if (chromosome->fitness > 0.0) {
+        two_opt_asymmetric(chromosome, costs, scale);
+        return;
+    }
+
     chromosome_create(&neighbor, N);
     chromosome_create(&best, N);
     best.fitness = -1.0;
+    best.length  = -1;
 
     // Tries every possible 2-opt combination
     for (i = 1; i < N; i++) {
         for (j = i + 1; j < N; j++) {
-            copy_and_reverse(&neighbor, chromosome, i, j, costs);
-            if (neighbor.fitness > best.fitness && neighbor.fitness > 0.0) {
+            copy_and_reverse(&neighbor, chromosome, i, j, costs, scale);
+            if (neighbor.fitness > 0.0 &&
+                chromosome_better(&neighbor, &best)) {
                 chromosome_copy(&best, &neighbor);
             }
         }
@@ -113,15 +1238,235 @@ static void two_opt(solver::Chromosome *chromosome, const double *costs) {
     chromosome_delete(&best);
 }
 
+
+
+/**
+ * Improves a chromosome on stored costs.
+ * Search stops as soon as a pass does not strictly improve the
+ * chromosome, exactly on integer costs, or time runs out; time is
+ * checked between passes. Candidate neighbours, if any, drive the search
+ * instead of passes.
+ * @param[in, out] chromosome  Chromosome to improve
+ * @param[in]      costs       Stored costs
+ * @param[in]      matrix      Cost matrix
+ * @param[in]      max_portion Longest portion moved by Or-opt, 0 for none
+ * @param[in, out] sw          Stopwatch started with the search
+ * @param[in]      max_time    Maximum execution time, 0 for no limit
+ */
+template <typename C>
+static void improve(
+    solver::Chromosome *chromosome,
+    const C &costs,
+    const solver::CostMatrix *matrix,
+    const unsigned int max_portion,
+    Stopwatch *sw,
+    const double max_time) {
+    solver::Chromosome previous;
+
+    if (matrix->k > 0 && chromosome->fitness > 0.0) {
+        neighbour_search(chromosome, costs, matrix, max_portion,
+                         sw, max_time);
+        evaluate(chromosome, costs, matrix->scale);
+        return;
+    }
+
+    do {
+        if (max_time > 0.0 && sw->stop().getUserTime() >= max_time) {
+            break;
+        }
+
+        // Fitness and length only are compared, genes are shared
+        previous = *chromosome;
+        two_opt(chromosome, costs, matrix->scale, matrix->symmetric);
+        if (max_portion > 0 && chromosome->fitness > 0.0) {
+            or_opt(chromosome, costs, matrix->scale, max_portion);
+        }
+    } while (solver::chromosome_better(chromosome, &previous));
+}
+
+
+/**
+ * Improves a chromosome on stored costs, using a variable-depth search.
+ * Chains of moves alternate with the local search of improve(), until
+ * chains do not improve the chromosome any more.
+ * @param[in, out] chromosome  Chromosome to improve
+ * @param[in]      costs       Stored costs
+ * @param[in]      matrix      Cost matrix, with candidate neighbours
+ * @param[in]      max_portion Longest portion moved by Or-opt, 0 for none
+ * @param[in]      max_depth   Longest chain of moves
+ * @param[in, out] sw          Stopwatch started with the search
+ * @param[in]      max_time    Maximum execution time, 0 for no limit
+ */
+template <typename C>
+static void variable_depth(
+    solver::Chromosome *chromosome,
+    const C &costs,
+    const solver::CostMatrix *matrix,
+    const unsigned int max_portion,
+    const unsigned int max_depth,
+    Stopwatch *sw,
+    const double max_time) {
+    improve(chromosome, costs, matrix, max_portion, sw, max_time);
+    while (chromosome->fitness > 0.0 &&
+           lin_kernighan(chromosome, costs, matrix, max_depth,
+                         sw, max_time)) {
+        improve(chromosome, costs, matrix, max_portion, sw, max_time);
+    }
+
+    // Chains cut back to nothing may leave genes rotated
+    evaluate(chromosome, costs, matrix->scale);
+}
+
+
+/** Action evaluating a chromosome on any stored costs. */
+struct Evaluation {
+    solver::Chromosome *chromosome;  ///< Chromosome to evaluate
+    double scale;                    ///< Scale factor of the stored costs
+
+    /** Evaluates the chromosome on given stored costs. */
+    template <typename C>
+    void operator()(const C &costs) {
+        evaluate(chromosome, costs, scale);
+    }
+};
+
+
+/**
+ * Action improving a chromosome on any stored costs.
+ * A variable-depth search is used when chains of moves are allowed.
+ */
+struct Improvement {
+    solver::Chromosome *chromosome;    ///< Chromosome to improve
+    const solver::CostMatrix *matrix;  ///< Cost matrix
+    unsigned int max_portion;          ///< Longest portion moved by Or-opt
+    unsigned int max_depth;            ///< Longest chain of moves, or 0
+    double max_time;                   ///< Maximum execution time, or 0
+
+    /** Improves the chromosome on given stored costs. */
+    template <typename C>
+    void operator()(const C &costs) {
+        Stopwatch sw;
+
+        sw.start();
+        if (max_depth > 0) {
+            variable_depth(chromosome, costs, matrix, max_portion,
+                           max_depth, &sw, max_time);
+        } else {
+            improve(chromosome, costs, matrix, max_portion, &sw, max_time);
+        }
+    }
+};
+
+
+/** Action looking up the stored cost of an arc. */
+struct Lookup {
+    unsigned int from;  ///< Gene the arc leaves
+    unsigned int to;    ///< Gene the arc enters
+    double cost;        ///< Stored cost of the arc
+
+    /** Looks up the arc in given stored costs. */
+    template <typename C>
+    void operator()(const C &costs) {
+        cost = costs(from, to);
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////
 
 
 
 namespace solver {
 
+void cost_matrix_create(CostMatrix *matrix, const Instance &instance) {
+    const unsigned int N = instance.getSize(),
+                       k = instance.getCandidateCount();
+
+    matrix->size      = N;
+    matrix->storage   = instance.getStorage();
+    matrix->precision = instance.getPrecision();
+    matrix->scale     = instance.getCostScale();
+    matrix->symmetric = instance.isSymmetric();
+    matrix->matrix    = &instance.getCosts();
+    switch (matrix->precision) {
+    case Instance::FLOAT:
+        matrix->costs = instance.getCostBlock<float>();
+        break;
+
+    case Instance::FIXED:
+        matrix->costs = instance.getCostBlock<int32_t>();
+        break;
+
+    default:
+        matrix->costs = (matrix->storage == Instance::TRIANGULAR)
+                      ? instance.getCostTriangle()
+                      : instance.getCostMatrix();
+    }
+
+    // Copies candidate neighbours, k slots per node
+    matrix->k              = k;
+    matrix->successors     = NULL;
+    matrix->n_successors   = NULL;
+    matrix->predecessors   = NULL;
+    matrix->n_predecessors = NULL;
+    if (k == 0) {
+        return;
+    }
+
+    SAFE_MALLOC(matrix->successors, unsigned int *,
+                N * k * sizeof(unsigned int));
+    SAFE_MALLOC(matrix->n_successors, unsigned int *,
+                N * sizeof(unsigned int));
+    SAFE_MALLOC(matrix->predecessors, unsigned int *,
+                N * k * sizeof(unsigned int));
+    SAFE_MALLOC(matrix->n_predecessors, unsigned int *,
+                N * sizeof(unsigned int));
+    for (unsigned int i = 0; i < N; i++) {
+        const unsigned int *candidates;
+        const double *weights;
+        unsigned int n;
+
+        n = instance.getOutCandidates(i, &candidates, &weights);
+        memcpy(matrix->successors + i * k, candidates,
+               n * sizeof(unsigned int));
+        matrix->n_successors[i] = n;
+
+        n = instance.getInCandidates(i, &candidates, &weights);
+        memcpy(matrix->predecessors + i * k, candidates,
+               n * sizeof(unsigned int));
+        matrix->n_predecessors[i] = n;
+    }
+}
+
+
+void cost_matrix_delete(CostMatrix *matrix) {
+    free(matrix->successors);
+    free(matrix->n_successors);
+    free(matrix->predecessors);
+    free(matrix->n_predecessors);
+    matrix->costs  = NULL;
+    matrix->matrix = NULL;
+    matrix->k      = 0;
+}
+
+
+double cost_matrix_get(
+    const CostMatrix *matrix,
+    const unsigned int from,
+    const unsigned int to) {
+    Lookup lookup;
+
+    lookup.from = from;
+    lookup.to   = to;
+    dispatch(matrix, &lookup);
+
+    return lookup.cost / matrix->scale;
+}
+
+
 void chromosome_create(Chromosome *chromosome, const unsigned int size) {
     SAFE_MALLOC(chromosome->genes, unsigned int *, size * sizeof(unsigned int));
     chromosome->size = size;
+    chromosome->length = -1;
 }
 
 
@@ -129,31 +1474,61 @@ void chromosome_delete(Chromosome *chromosome) {
     free(chromosome->genes);
     chromosome->size = 0;
     chromosome->fitness = 0.0;
+    chromosome->length = -1;
 }
 
 
 void chromosome_copy(Chromosome *dst, const Chromosome *src) {
     memcpy(dst->genes, src->genes, dst->size * sizeof(unsigned int));
     dst->fitness = src->fitness;
+    dst->length  = src->length;
 }
 
 
-void chromosome_evaluate(Chromosome *chromosome, const double *costs) {
-    const unsigned int size = chromosome->size;
-    unsigned int i;
-    unsigned int *genes = chromosome->genes;
-    double cost = 0.0;
+void chromosome_evaluate(Chromosome *chromosome, const CostMatrix *costs) {
+    Evaluation evaluation;
 
-    for (i = 0; i < size; i++) {
-        const double arc = costs[genes[i] * size + genes[(i + 1) % size]];
-        if (arc < 0.0) {
-            cost = -1.0;
-            break;
-        }
-        cost += arc;
+    evaluation.chromosome = chromosome;
+    evaluation.scale      = costs->scale;
+    dispatch(costs, &evaluation);
+}
+
+
+void chromosome_encode(
+    Chromosome *chromosome,
+    const std::vector<Node> &solution,
+    const Instance &instance,
+    const CostMatrix *costs) {
+    const unsigned int N = solution.size();
+
+    for (unsigned int i = 0; i < N; i++) {
+        chromosome->genes[i] = instance.getIndex(solution[i].getId());
     }
 
-    chromosome->fitness = 1.0 / cost;
+    chromosome_evaluate(chromosome, costs);
+}
+
+
+std::vector<Node> chromosome_decode(
+    const Chromosome *chromosome,
+    const std::vector<Node> &nodes) {
+    std::vector<Node> solution;
+
+    solution.reserve(chromosome->size);
+    for (unsigned int i = 0; i < chromosome->size; i++) {
+        solution.push_back(nodes[chromosome->genes[i]]);
+    }
+
+    return solution;
+}
+
+
+bool chromosome_better(const Chromosome *A, const Chromosome *B) {
+    if (A->length >= 0 && B->length >= 0) {
+        return A->length < B->length;
+    }
+
+    return A->fitness > B->fitness;
 }
 
 
@@ -175,6 +1550,7 @@ void chromosome_crossover(
     Chromosome *offspring,
     const Chromosome *parent1,
     const Chromosome *parent2) {
+    RNG &rng = RNG::local();
     const unsigned int N = offspring->size,
                        p = static_cast<int>(rng.uniform(1.0, N - 1.0));
     bool *already_in;
@@ -201,6 +1577,7 @@ void chromosome_crossover(
 
 
 void chromosome_mutation(Chromosome *chromosome) {
+    RNG &rng = RNG::local();
     const unsigned int N = chromosome->size,
                        i = static_cast<int>(rng.uniform(1.0, N - 0.0)),
                        j = static_cast<int>(rng.uniform(1.0, N - 0.0)),
@@ -217,15 +1594,49 @@ void chromosome_mutation(Chromosome *chromosome) {
 
 
 /**
+ * Longer portions are moved up to MAX_PORTION genes at a time.
  * @todo This could be improved with plateaux, radomization, etc...
  */
-void chromosome_improvement(Chromosome *chromosome, const double *costs) {
-    double old_fitness = -2.0;
+void chromosome_improvement(
+    Chromosome *chromosome,
+    const CostMatrix *costs,
+    const unsigned int max_portion) {
+    const unsigned int portion = (max_portion < MAX_PORTION)
+                               ? max_portion
+                               : MAX_PORTION;
+    Improvement improvement;
 
-    while (chromosome->fitness > old_fitness) {
-        old_fitness = chromosome->fitness;
-        two_opt(chromosome, costs);
-    }
+    improvement.chromosome  = chromosome;
+    improvement.matrix      = costs;
+    improvement.max_portion = portion;
+    improvement.max_depth   = 0;
+    improvement.max_time    = 0.0;
+    dispatch(costs, &improvement);
+}
+
+
+
+/**
+ * Chains are built on candidate neighbours only.
+ */
+void chromosome_lin_kernighan(
+    Chromosome *chromosome,
+    const CostMatrix *costs,
+    const unsigned int max_portion,
+    const unsigned int max_depth,
+    const double max_time) {
+    const unsigned int portion = (max_portion < MAX_PORTION)
+                               ? max_portion
+                               : MAX_PORTION;
+
+    Improvement improvement;
+
+    improvement.chromosome  = chromosome;
+    improvement.matrix      = costs;
+    improvement.max_portion = portion;
+    improvement.max_depth   = (costs->k > 0) ? max_depth : 0;
+    improvement.max_time    = max_time;
+    dispatch(costs, &improvement);
 }
 
 }  // namespace solver
@@ -16,19 +16,90 @@
 #ifndef SOLVER_CHROMOSOME_H_
 #define SOLVER_CHROMOSOME_H_
 
+#include <stdint.h>
+
+#include <vector>
+
+#include "../Instance.h"
+
 namespace solver {
 
-/** A chromosome of a genetic algorithm. */
+/**
+ * Costs of an instance, as the instance stores them.
+ * Dense blocks, with elements of any supported type, and upper
+ * triangles are read directly; sparse and lazy matrices are asked for
+ * each cost, so that they are never expanded.
+ * Candidate neighbours, if any, take k slots per gene, sorted by cost.
+ */
+struct cost_matrix_s {
+    const void *costs;              ///< Dense block or triangle, if any
+    const matrix::Matrix *matrix;   ///< Cost matrix of the instance
+    unsigned int size;              ///< Number of genes
+    Instance::Storage storage;      ///< Storage of the costs
+    Instance::Precision precision;  ///< Type of the stored costs
+    double scale;                   ///< Scale factor of the costs
+    bool symmetric;                 ///< Whether costs are symmetric
+    unsigned int k;                 ///< Candidates per gene, or 0
+    unsigned int *successors;       ///< Candidate successors
+    unsigned int *n_successors;     ///< Successors of each gene
+    unsigned int *predecessors;     ///< Candidate predecessors
+    unsigned int *n_predecessors;   ///< Predecessors of each gene
+};
+
+/** Type of a cost matrix. */
+typedef struct cost_matrix_s CostMatrix;
+
+
+/**
+ * A chromosome of a genetic algorithm.
+ * Fitness is the reciprocal of the cost of the tour. On integer costs,
+ * the length of the tour is also kept exactly, in stored units, so that
+ * chromosomes are compared without rounding errors.
+ */
 struct chromosome_s {
     unsigned int *genes;  ///< Genes
     unsigned int size;    ///< Number of genes
     double fitness;       ///< Fitness
+    int64_t length;       ///< Exact length, negative if unknown or unfeasible
 };
 
 /** Type of a chromosome. */
 typedef struct chromosome_s Chromosome;
 
 
+/**
+ * Creates a cost matrix for an instance.
+ * Costs stored by the instance are used as they are, whatever their
+ * storage: cost matrix refers to the instance, which must outlive it.
+ * Candidate neighbours of the instance, if any, are copied.
+ * @param[out] matrix   Pointer to cost matrix to create
+ * @param[in]  instance Instance
+ * @note cost_matrix_delete must be called to deallocate resources
+ */
+void cost_matrix_create(CostMatrix *matrix, const Instance &instance);
+
+
+/**
+ * Deletes a cost matrix.
+ * Deallocates resources of a cost matrix.
+ * @param[out] matrix Cost matrix to destroy
+ */
+void cost_matrix_delete(CostMatrix *matrix);
+
+
+/**
+ * Returns the cost of an arc.
+ * @param[in] matrix Cost matrix
+ * @param[in] from   Gene the arc leaves
+ * @param[in] to     Gene the arc enters
+ * @return Unscaled cost of the arc, negative if there is no such arc
+ */
+double cost_matrix_get(
+    const CostMatrix *matrix,
+    const unsigned int from,
+    const unsigned int to);
+
+
 /**
  * Creates a chromosome.
  * Allocates space for a chromosome.
@@ -57,13 +128,50 @@ void chromosome_delete(Chromosome *chromosome);
 void chromosome_copy(Chromosome *dst, const Chromosome *src);
 
 
+/**
+ * Encodes a solution into a chromosome.
+ * Genes are dense indices of nodes in the instance.
+ * @param[out] chromosome Chromosome encoding the solution
+ * @param[in]  solution   Solution to encode
+ * @param[in]  instance   Original instance
+ * @param[in]  costs      Cost matrix of the instance
+ */
+void chromosome_encode(
+    Chromosome *chromosome,
+    const std::vector<Node> &solution,
+    const Instance &instance,
+    const CostMatrix *costs);
+
+
+/**
+ * Decodes a chromosome.
+ * @param[in] chromosome Chromosome to decode
+ * @param[in] nodes      Nodes of the instance, by dense index
+ * @return Solution encoded by the chromosome
+ */
+std::vector<Node> chromosome_decode(
+    const Chromosome *chromosome,
+    const std::vector<Node> &nodes);
+
+
 /**
  * Evaluates a chromosome.
  * Sets the fitness of a chromosome using given cost matrix.
+ * Fitness is computed from unscaled costs, whatever the precision.
  * @param[in, out] chromosome Chromosome to evaluate
  * @param[in]      costs      Costs matrix
  */
-void chromosome_evaluate(Chromosome *chromosome, const double *costs);
+void chromosome_evaluate(Chromosome *chromosome, const CostMatrix *costs);
+
+
+/**
+ * Tells whether a chromosome is strictly better than another one.
+ * Exact lengths are compared when both are known, fitnesses otherwise.
+ * @param[in] A Pointer to first chromosome
+ * @param[in] B Pointer to second chromosome
+ * @return True iff A is strictly better than B
+ */
+bool chromosome_better(const Chromosome *A, const Chromosome *B);
 
 
 /**
@@ -103,11 +211,55 @@ void chromosome_mutation(Chromosome *chromosome);
 
 /**
  * Improves a chromosome using a local search.
- * Performs a simple Hill-Climbing to improve this chromosome
- * @param[in, out] chromosome Pointer to chromosome to improve
- * @param[in]      costs      Cost matrix
+ * Performs a simple Hill-Climbing to improve this chromosome. On
+ * symmetric costs, 2-opt moves of feasible chromosomes are evaluated in
+ * constant time.
+ * Besides 2-opt, Or-opt moves relocate portions of up to 3 genes
+ * elsewhere, as they are or reversed, each evaluated in constant time:
+ * unlike 2-opt, a portion keeping its orientation keeps the costs of its
+ * inner arcs on asymmetric costs.
+ * If the cost matrix has candidate neighbours, feasible chromosomes are
+ * improved by moves joining a gene to its candidates only, driven by a
+ * queue of genes whose neighbourhood changed (don't-look bits).
+ * @param[in, out] chromosome  Pointer to chromosome to improve
+ * @param[in]      costs       Cost matrix
+ * @param[in]      max_portion Longest portion moved by Or-opt, up to 3,
+ *                             0 disables Or-opt
+ */
+void chromosome_improvement(
+    Chromosome *chromosome,
+    const CostMatrix *costs,
+    const unsigned int max_portion);
+
+
+/**
+ * Improves a chromosome using a variable-depth local search.
+ * Moves of a Lin-Kernighan search on asymmetric costs are sequential
+ * 3-opt exchanges, which swap two consecutive portions of the chromosome
+ * and so keep the orientation of every arc; each one is evaluated in
+ * constant time. Starting from a gene, a chain of such moves is built,
+ * each one breaking the arc closed by the previous one and joining genes
+ * to their candidate neighbours, as long as the gain of the open chain
+ * stays positive; the chain is then cut back to its best prefix. Search
+ * alternates with the local search of chromosome_improvement(), until
+ * neither improves the chromosome or time runs out.
+ * Chromosomes which are not feasible, or cost matrices without candidate
+ * neighbours, are improved by the local search of chromosome_improvement()
+ * alone, which stops as well when time runs out.
+ * @param[in, out] chromosome  Pointer to chromosome to improve
+ * @param[in]      costs       Cost matrix
+ * @param[in]      max_portion Longest portion moved by Or-opt, up to 3,
+ *                             0 disables Or-opt
+ * @param[in]      max_depth   Longest chain of moves
+ * @param[in]      max_time    Maximum execution time (in seconds), 0 for
+ *                             no limit
  */
-void chromosome_improvement(Chromosome *chromosome, const double *costs);
+void chromosome_lin_kernighan(
+    Chromosome *chromosome,
+    const CostMatrix *costs,
+    const unsigned int max_portion,
+    const unsigned int max_depth,
+    const double max_time);
 
 }  // namespace solver
 
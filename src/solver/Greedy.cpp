@@ -13,7 +13,10 @@
  * You should have received a copy of the GNU General Public License
  * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <cfloat>
+#include <stdint.h>
+
+#include <climits>
+#include <limits>
 #include <vector>
 
 #include "Greedy.h"
@@ -22,30 +25,123 @@ using std::vector;
 
 namespace solver {
 
+/** Marks a search which found no node. */
+static const unsigned int NOT_FOUND = UINT_MAX;
+
+
 /**
- * Searches closest node in a list of candidates.
- * Returns index of such node.
- * @param[in] node       Current node
- * @param[in] instance   Instance to solve
- * @param[in] candidates List of candidates to look in
- * @return Index of the closest node
+ * Searches closest node among the ones not visited yet.
+ * Arcs with null cost are ignored; ties are broken by index. When no arc
+ * can be used, first node not visited yet is returned.
+ * @param[in] row     Costs of the arcs leaving current node
+ * @param[in] visited Whether each node has already been visited
+ * @return Dense index of the closest node
  */
+template <typename T>
 static unsigned int search_closest(
-    const Node *node,
-    const Instance &instance,
-    const vector<Node *> &candidates) {
-    double minCost = DBL_MAX;
-    unsigned int id = node->getId(),
-                 idx = 0;
-    for (unsigned int i = 0; i < candidates.size(); i++) {
-        const double cost = instance.getCost(id, candidates[i]->getId());
-        if (cost < minCost && cost > 0.0) {
+    const T *row,
+    const vector<bool> &visited) {
+    T minCost = std::numeric_limits<T>::max();
+    unsigned int idx = NOT_FOUND, first = NOT_FOUND;
+    for (unsigned int i = 0; i < visited.size(); i++) {
+        if (visited[i]) {
+            continue;
+        }
+        first = (first == NOT_FOUND) ? i : first;
+
+        const T cost = row[i];
+        if (cost < minCost && cost > 0) {
             minCost = cost;
             idx     = i;
         }
     }
 
-    return idx;
+    return (idx != NOT_FOUND) ? idx : first;
+}
+
+
+/**
+ * Searches closest node among the candidate successors of a node.
+ * Candidates are sorted by cost, so the first one not visited yet (and
+ * with non null cost) is the closest node overall.
+ * @param[in] instance Instance to solve
+ * @param[in] current  Dense index of current node
+ * @param[in] visited  Whether each node has already been visited
+ * @return Dense index of the closest node, NOT_FOUND if every candidate
+ *         has already been visited
+ */
+static unsigned int search_candidates(
+    const Instance &instance,
+    const unsigned int current,
+    const vector<bool> &visited) {
+    const unsigned int *targets;
+    const double *costs;
+    const size_t n = instance.getOutCandidates(current, &targets, &costs);
+
+    for (size_t i = 0; i < n; i++) {
+        if (!visited[targets[i]] && costs[i] > 0.0) {
+            return targets[i];
+        }
+    }
+
+    return NOT_FOUND;
+}
+
+
+/**
+ * Searches closest node among the arcs leaving current node.
+ * Arcs are scanned as the cost matrix stores them: rows of dense
+ * matrices are scanned as they are, whatever the type of their elements,
+ * while other matrices list existing arcs only, so that they are never
+ * expanded. When no arc can be used, first node not visited yet is
+ * returned, as search_closest() does.
+ * @param[in]  instance Instance to solve
+ * @param[in]  current  Dense index of current node
+ * @param[in]  visited  Whether each node has already been visited
+ * @param[out] targets  Buffer for targets of the arcs, size elements
+ * @param[out] costs    Buffer for costs of the arcs, size elements
+ * @return Dense index of the closest node
+ */
+static unsigned int search_row(
+    const Instance &instance,
+    const unsigned int current,
+    const vector<bool> &visited,
+    vector<unsigned int> *targets,
+    vector<double> *costs) {
+    const size_t N = instance.getSize();
+    const double *doubles = instance.getCostMatrix();
+    const float *floats = instance.getCostBlock<float>();
+    const int32_t *fixed = instance.getCostBlock<int32_t>();
+
+    if (doubles != NULL) {
+        return search_closest(doubles + current * N, visited);
+    } else if (floats != NULL) {
+        return search_closest(floats + current * N, visited);
+    } else if (fixed != NULL) {
+        return search_closest(fixed + current * N, visited);
+    }
+
+    const size_t n = instance.getOutArcs(current, &(*targets)[0],
+                                         &(*costs)[0]);
+    double minCost = std::numeric_limits<double>::max();
+    unsigned int idx = NOT_FOUND;
+    for (size_t a = 0; a < n; a++) {
+        const double cost = (*costs)[a];
+        if (!visited[(*targets)[a]] && cost < minCost && cost > 0) {
+            minCost = cost;
+            idx     = (*targets)[a];
+        }
+    }
+    if (idx != NOT_FOUND) {
+        return idx;
+    }
+
+    for (unsigned int i = 0; i < visited.size(); i++) {
+        if (!visited[i]) {
+            return i;
+        }
+    }
+    return NOT_FOUND;
 }
 
 
@@ -53,27 +149,32 @@ Greedy::~Greedy() {
 }
 
 
+/**
+ * Candidate successors are looked up first, if the instance has them;
+ * the whole row is scanned only when every candidate has been visited.
+ */
 Solution Greedy::solve(const Instance &instance) const {
-    vector<Node *> candidates;
+    const unsigned int N = instance.getSize();
+    vector<unsigned int> targets(N);
+    vector<double> costs(N);
+    vector<bool> visited(N, false);
     vector<Node> solution,
                  nodes(instance.getNodesAsVector());
 
-    // Initializes vector of candidates
-    for (unsigned int i = 0; i < nodes.size(); i++) {
-        candidates.push_back(&nodes[i]);
-    }
-
-    Node *current = candidates[0];
-    solution.push_back(*current);
-    candidates.erase(candidates.begin());
-    while (candidates.size() > 0) {
+    unsigned int current = 0;
+    solution.push_back(nodes[current]);
+    visited[current] = true;
+    for (unsigned int step = 1; step < N; step++) {
         // Selects nearest node
-        unsigned int minIdx = search_closest(current, instance, candidates);
-        current = candidates[minIdx];
+        unsigned int next = search_candidates(instance, current, visited);
+        if (next == NOT_FOUND) {
+            next = search_row(instance, current, visited, &targets, &costs);
+        }
+        current = next;
 
-        // Pushes nearest node into solution and removes it from candidates
-        solution.push_back(*current);
-        candidates.erase(candidates.begin() + minIdx);
+        // Pushes nearest node into solution and marks it as visited
+        solution.push_back(nodes[current]);
+        visited[current] = true;
     }
 
     return Solution(solution, instance);
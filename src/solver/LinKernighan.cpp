@@ -0,0 +1,190 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "LinKernighan.h"
+#include "Chromosome.h"
+#include "Greedy.h"
+#include "../Stopwatch.h"
+#include "../RNG.h"
+
+
+/**
+ * Prints an error when malloc cannot allocate memory.
+ */
+#define MALLOC_ERROR \
+  fprintf(stderr, "[%s: %d]: Cannot allocate memory.\n", __FILE__, __LINE__)
+
+
+/**
+ * Performs a memory allocation and checks for the result.
+ */
+#define SAFE_MALLOC(var, type, size)              \
+    (var) = reinterpret_cast<type>(malloc(size)); \
+    if (NULL == (var)) {                          \
+        MALLOC_ERROR;                             \
+    }
+
+
+
+////////////////////////////////////////////////////////////////////////
+// Non member support functions
+
+/** Longest portion swapped by a double bridge. */
+static const unsigned int MAX_BRIDGE = 50;
+
+/** Draws of a double bridge before giving up. */
+static const unsigned int MAX_DRAWS = 100;
+
+
+/**
+ * Perturbs a chromosome with a double bridge.
+ * Two consecutive portions of random length, starting at a random
+ * position, swap places, so that orientation of every arc is kept.
+ * Portions are short, so that the perturbation stays local. Positions
+ * are drawn again until the three arcs joining the portions exist, so
+ * that a feasible chromosome stays feasible on sparse costs.
+ * @param[in, out] chromosome Chromosome to perturb, at least 4 genes
+ * @param[in]      costs      Cost matrix
+ * @return True iff the chromosome has been perturbed
+ */
+static bool double_bridge(
+    solver::Chromosome *chromosome,
+    const solver::CostMatrix *costs) {
+    RNG &rng = RNG::local();
+    const unsigned int N = chromosome->size,
+                       L = (N / 3 < MAX_BRIDGE) ? N / 3 : MAX_BRIDGE;
+    unsigned int *genes = chromosome->genes, *portion;
+    unsigned int i = 0, b = 0, c = 0, draw;
+
+    for (draw = 0; draw < MAX_DRAWS; draw++) {
+        // Portions start at position i and take b and c genes
+        i = static_cast<unsigned int>(rng.uniform(1.0, N - 2.0));
+        const unsigned int max_b = (L < N - i - 1) ? L : N - i - 1;
+        b = 1 + static_cast<unsigned int>(rng.uniform(0, max_b));
+        const unsigned int max_c = (L < N - i - b) ? L : N - i - b;
+        c = 1 + static_cast<unsigned int>(rng.uniform(0, max_c));
+
+        const unsigned int last = (i + b + c) % N;
+        if (solver::cost_matrix_get(costs, genes[i - 1], genes[i + b]) >= 0
+            && solver::cost_matrix_get(costs, genes[i + b + c - 1],
+                                       genes[i]) >= 0
+            && solver::cost_matrix_get(costs, genes[i + b - 1],
+                                       genes[last]) >= 0) {
+            break;
+        }
+    }
+    if (draw == MAX_DRAWS) {
+        return false;
+    }
+
+    SAFE_MALLOC(portion, unsigned int *, c * sizeof(unsigned int));
+    memcpy(portion, genes + i + b, c * sizeof(unsigned int));
+    memmove(genes + i + c, genes + i, b * sizeof(unsigned int));
+    memcpy(genes + i, portion, c * sizeof(unsigned int));
+    free(portion);
+    return true;
+}
+////////////////////////////////////////////////////////////////////////
+// End of non member support functions
+
+
+
+namespace solver {
+
+LinKernighan::LinKernighan(
+    const double maxTime,
+    const unsigned int maxDepth,
+    const unsigned int maxPortion) :
+maxTime(maxTime), maxDepth(maxDepth), maxPortion(maxPortion) {
+}
+
+
+
+LinKernighan::~LinKernighan() {
+}
+
+
+
+/**
+ * Uses direct memory management for performance reasons, as AGLSA does.
+ * Without candidate neighbours, solutions are improved by the local
+ * search of the genetic algorithm instead, and time is checked between
+ * its passes. Only feasible solutions are perturbed: improving
+ * unfeasible ones would fall back to a full 2-opt search.
+ * Time spent loading costs and building the greedy solution counts
+ * against the budget, though neither can be interrupted: the greedy
+ * solution is not improved at all once time has run out.
+ */
+Solution LinKernighan::solve(const Instance &instance) const {
+    const unsigned int N = instance.getSize();
+    const vector<Node> nodes(instance.getNodesAsVector());
+    CostMatrix costs;
+    Chromosome best, current;
+    Stopwatch sw;
+    double time;
+
+    sw.start();
+    cost_matrix_create(&costs, instance);
+    chromosome_create(&best, N);
+    chromosome_create(&current, N);
+
+
+    // Improves a greedy solution
+    Greedy greedy;
+    Solution start = greedy(instance);
+    chromosome_encode(&best, start.getNodesAsVector(), instance, &costs);
+    time = sw.stop().getUserTime();
+    if (maxTime <= 0.0 || time < maxTime) {
+        chromosome_lin_kernighan(&best, &costs, maxPortion, maxDepth,
+                                 (maxTime > 0.0) ? maxTime - time : 0.0);
+    }
+
+
+    // Perturbs and improves the best solution found so far
+    time = sw.stop().getUserTime();
+    while (time < maxTime && N >= 8 && best.fitness > 0.0) {
+        chromosome_copy(&current, &best);
+        if (!double_bridge(&current, &costs)) {
+            time = sw.stop().getUserTime();
+            continue;
+        }
+        chromosome_evaluate(&current, &costs);
+        chromosome_lin_kernighan(&current, &costs, maxPortion, maxDepth,
+                                 maxTime - time);
+        if (chromosome_better(&current, &best)) {
+            chromosome_copy(&best, &current);
+        }
+
+        time = sw.stop().getUserTime();
+    }
+
+
+    // Builds solution as vector of nodes
+    vector<Node> solution(chromosome_decode(&best, nodes));
+
+    chromosome_delete(&best);
+    chromosome_delete(&current);
+    cost_matrix_delete(&costs);
+
+    return Solution(solution, instance);
+}
+
+}  // namespace solver
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2015 Marco Zanella
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SOLVER_LINKERNIGHAN_H_
+#define SOLVER_LINKERNIGHAN_H_
+
+#include "Solver.h"
+
+namespace solver {
+
+/**
+ * Solves an instance of the problem using a Lin-Kernighan search.
+ * A greedy solution is improved by a variable-depth local search made of
+ * chains of sequential 3-opt moves on candidate neighbours; then, until
+ * time runs out, the best solution found so far is perturbed by a double
+ * bridge and improved again (Iterated Lin-Kernighan).
+ *
+ * This class follows the Strategy Design Pattern.
+ *
+ * @author Marco Zanella <marco.zanella.9@studenti.unipd.it>
+ */
+class LinKernighan: public Solver {
+ public:
+    /**
+     * Constructor.
+     * @param[in] maxTime    Maximum accepted execution time (in seconds)
+     * @param[in] maxDepth   Longest chain of moves
+     * @param[in] maxPortion Longest portion moved by Or-opt, up to 3
+     */
+    explicit LinKernighan(
+        const double maxTime = 5.0,
+        const unsigned int maxDepth = 10,
+        const unsigned int maxPortion = 3);
+
+
+    /**
+     * Destructor.
+     */
+    virtual ~LinKernighan();
+
+
+    /**
+     * Solves an instance of problem.
+     * Solution is build using an Iterated Lin-Kernighan search.
+     * @param[in] instance Instance to solve
+     * @return Solution for that instance
+     */
+    virtual Solution solve(const Instance &instance) const;
+
+
+
+ private:
+    const double maxTime;             ///< Maximum execution time
+    const unsigned int maxDepth;      ///< Longest chain of moves
+    const unsigned int maxPortion;    ///< Longest portion moved by Or-opt
+};
+
+}  // namespace solver
+
+#endif  // SOLVER_LINKERNIGHAN_H_
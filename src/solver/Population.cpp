@@ -40,19 +40,18 @@
     }
 
 
-/** Random number generator. */
-static RNG rng;
-
 /**
  * Compares two chromosomes.
  * @param[in] A Pointer to first chromosome
  * @param[in] B Poinyer to second chromosome
- * @return -1, 0 or +1 if A has a better, equal or worse fitness than B
+ * @return -1, 0 or +1 if A is better than, as good as or worse than B
  */
 int chromosome_compare(const void *A, const void *B) {
-    const double fA = ((solver::Chromosome *) A)->fitness,
-                 fB = ((solver::Chromosome *) B)->fitness;
-    return (fA > fB) ? -1 : ((fA < fB) ? +1 : 0);
+    const solver::Chromosome *cA = (const solver::Chromosome *) A,
+                             *cB = (const solver::Chromosome *) B;
+    return solver::chromosome_better(cA, cB)
+         ? -1
+         : (solver::chromosome_better(cB, cA) ? +1 : 0);
 }
 
 
@@ -62,7 +61,7 @@ void population_create(
     Population *population,
     const unsigned int maxSize,
     const unsigned int N,
-    const double *costs) {
+    const CostMatrix *costs) {
     SAFE_MALLOC(
         population->chromosomes,
         Chromosome *,
@@ -99,7 +98,7 @@ void population_variance(Population *population) {
         if (c[i].fitness > 0.0) {
             mean += 1.0 / c[i].fitness;
             size++;
-            if (c[i].fitness < c[min].fitness) {
+            if (chromosome_better(c + min, c + i)) {
                 min = i;
             }
         }
@@ -138,7 +137,7 @@ void population_select(Population *population, Chromosome *chromosome) {
     }
 
     // Chooses a chromosome
-    const double p = rng.uniform(0.0, 1.0);
+    const double p = RNG::local().uniform(0.0, 1.0);
     unsigned int i = N - 1;
     double sum = rank[0];
     while (sum < p) {
@@ -165,7 +164,7 @@ bool population_accept(
     while (j < i) {
         // If distance is smaller than threshold, accepts with probability P
         if (chromosome_hamming_distance(c + i, c + j) < min_d) {
-            return rng.uniform(0.0, 1.0) < P;
+            return RNG::local().uniform(0.0, 1.0) < P;
         }
         j++;
     }
@@ -179,6 +178,7 @@ void population_next_generation(
     Population *population,
     Population *next,
     const GAConf *configuration) {
+    RNG &rng = RNG::local();
     Chromosome parent1, parent2;
     chromosome_create(&parent1, population->chromosomes[0].size);
     chromosome_create(&parent2, population->chromosomes[0].size);
@@ -227,7 +227,10 @@ void population_next_generation(
         if (cost > 0.0 &&
             cost < mean - sd &&
             rng.uniform(0.0, 1.0) < p_improvement) {
-            chromosome_improvement(next->chromosomes + i, population->costs);
+            chromosome_lin_kernighan(next->chromosomes + i,
+                                     population->costs,
+                                     configuration->or_opt,
+                                     configuration->depth, 0.0);
         }
 
         // Adds offspring to population if it meets acceptance criteria
@@ -28,7 +28,7 @@ struct population_s {
     double mean;              ///< Mean fitness
     double sigma2;            ///< Variance of fitnesses
     Chromosome *worst;        ///< Pointer to worst chromosome
-    const double *costs;      ///< Cost matrix
+    const CostMatrix *costs;  ///< Cost matrix
 };
 
 /** Configuration of a genetic algorithm. */
@@ -40,6 +40,11 @@ struct ga_conf_s {
     double P;                ///< Probability to accept a chromosome when
                              ///< there is a similar one in the population
     double p_improvement;    ///< Probability of improve a good chromosome
+    unsigned int or_opt;     ///< Longest portion moved by Or-opt while
+                             ///< improving, 0 disables Or-opt
+    unsigned int depth;      ///< Longest chain of moves of the
+                             ///< variable-depth search while improving,
+                             ///< 0 disables it
 };
 
 
@@ -63,7 +68,7 @@ void population_create(
     Population *population,
     const unsigned int maxSize,
     const unsigned int N,
-    const double *costs);
+    const CostMatrix *costs);
 
 
 /**
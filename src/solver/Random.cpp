@@ -15,11 +15,11 @@
  */
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
-#include <time.h>
 
+#include <algorithm>
 #include <vector>
 
+#include "../RNG.h"
 #include "Random.h"
 
 using std::vector;
@@ -34,14 +34,13 @@ Solution Random::solve(const Instance &instance) const {
     unsigned int size = instance.getSize();
     vector<Node> nodes = instance.getNodesAsVector();
 
-    unsigned int seed = time(NULL);
+    RNG &rng = RNG::local();
 
     for (unsigned int i = 0; i < size; i++) {
-        unsigned int newPosition = rand_r(&seed) % size;
-        Node swapNode(nodes[i]);
-
-        memcpy(&nodes[i], &nodes[newPosition], sizeof(Node));
-        memcpy(&nodes[newPosition], &swapNode, sizeof(Node));
+        unsigned int newPosition = i
+            + static_cast<unsigned int>(rng.uniform(0.0, size - i))
+            % (size - i);
+        std::swap(nodes[i], nodes[newPosition]);
     }
 
     return Solution(nodes, instance);